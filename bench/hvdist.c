@@ -0,0 +1,143 @@
+// Copyright © 2020 Neven Sajko. All rights reserved.
+
+// Measures the throughput of hvdistBatch (see kernels/hvdist.c), in
+// pairs of points per second, against the scalar hvdist and against
+// the haversine formula written with libm's sin and cos.
+//
+// Usage:
+//
+//    hvdist [pairs [repetitions]]
+//
+// The pairs of points are random, with latitudes in [-pi/2, pi/2] and
+// longitudes in [-pi, pi], kept in separate arrays. Build with
+// optimization and for the target machine, e.g.:
+//
+//    cc -O3 -march=native -Ikernels bench/hvdist.c kernels/*.c -lm
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <kernels.h>
+
+#define nil 0
+
+static
+void
+usage(void) {
+	fprintf(stderr, "usage: hvdist [pairs [repetitions]]\n");
+	exit(2);
+}
+
+static
+double
+now(void) {
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return (double)t.tv_sec + 1e-9*(double)t.tv_nsec;
+}
+
+static
+double
+libmHvdist(double lat1, double lon1, double lat2, double lon2) {
+	double s = sin((lat2 - lat1)/2), t = sin((lon2 - lon1)/2);
+	return 2 * asin(sqrt(s*s + cos(lat1)*cos(lat2)*t*t));
+}
+
+typedef struct {
+	const double *lat1, *lon1, *lat2, *lon2;
+	double *d;
+	size_t n;
+} pairs;
+
+static
+void
+runBatch(const pairs *p) {
+	hvdistBatch(p->lat1, p->lon1, p->lat2, p->lon2, p->d, p->n);
+}
+
+static
+void
+runScalar(const pairs *p) {
+	size_t i;
+	for (i = 0; i < p->n; i++) {
+		p->d[i] = hvdist(p->lat1[i], p->lon1[i], p->lat2[i], p->lon2[i]);
+	}
+}
+
+static
+void
+runLibm(const pairs *p) {
+	size_t i;
+	for (i = 0; i < p->n; i++) {
+		p->d[i] = libmHvdist(p->lat1[i], p->lon1[i], p->lat2[i], p->lon2[i]);
+	}
+}
+
+typedef struct {
+	const char *name;
+	void (*run)(const pairs *);
+} method;
+
+static const method methods[] = {
+	{"hvdistBatch", runBatch},
+	{"hvdist", runScalar},
+	{"libm", runLibm},
+};
+
+int
+main(int argc, char *argv[]) {
+	long n = 1L << 20, reps = 20;
+	char *end;
+	if (argc > 3) {
+		usage();
+	}
+	if (argc > 1) {
+		n = strtol(argv[1], &end, 10);
+		if (*end != '\0' || n <= 0) {
+			usage();
+		}
+	}
+	if (argc > 2) {
+		reps = strtol(argv[2], &end, 10);
+		if (*end != '\0' || reps <= 0) {
+			usage();
+		}
+	}
+
+	const double pi = 3.14159265358979323846;
+	double *buf = malloc(5 * (size_t)n * sizeof(double));
+	if (buf == nil) {
+		fprintf(stderr, "hvdist: out of memory\n");
+		return 1;
+	}
+	pairs p = {buf, buf + n, buf + 2*n, buf + 3*n, buf + 4*n, (size_t)n};
+	long i;
+	srand(1);
+	for (i = 0; i < 4*n; i++) {
+		// Latitudes in the first and the third array.
+		double scale = (i / n) % 2 == 0 ? pi/2 : pi;
+		buf[i] = scale * (2*(double)rand()/RAND_MAX - 1);
+	}
+
+	int k;
+	for (k = 0; k < (int)(sizeof(methods) / sizeof(methods[0])); k++) {
+		methods[k].run(&p); // warm up
+		double t = now();
+		long r;
+		for (r = 0; r < reps; r++) {
+			methods[k].run(&p);
+		}
+		t = now() - t;
+		double sum = 0;
+		for (i = 0; i < n; i++) {
+			sum += p.d[i];
+		}
+		printf("%-12s %8.2f Mpairs/s  (sum %.17g)\n", methods[k].name, (double)n * (double)reps / t * 1e-6, sum);
+	}
+	free(buf);
+	return 0;
+}
@@ -1,5 +1,7 @@
 // Copyright 2020 Neven Sajko <nsajko@gmail.com>. All rights reserved.
 
+#define __STDC_WANT_IEC_60559_TYPES_EXT__
+
 #include <spawn.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -9,50 +11,46 @@
 
 #define nil 0
 
+enum {
+	// Enough for FloatFricasMaxDigits digits, with the exponent.
+	NumberBufferSize = 80,
+};
+
 // TODO: provide access to Fricas's interval computation facilities
 // (package Interval)?
 
-ieee754FloatingPointNumber
-FricasFloatEval(FloatFricas f, const char *fricasCmd, ieee754FloatingPointNumber x) {
+// Reads the result of the last command sent to Fricas into num, and
+// returns the start of the number in num, or nil on failure.
+static
+char *
+readNumber(FloatFricas f, char num[NumberBufferSize]) {
 	// Lexes the floating point value from lines like these that
 	// Fricas outputs (note the space after the minus sign):
 	//
 	//    (13)  0.3300000000000000000000000E1
 	//    (1)  - 0.3300000000000000000000000E1
 
-	// TODO: Maybe return a custom NaN for each error?
-	const ieee754FloatingPointNumber nan = (ieee754FloatingPointNumber)0 / (ieee754FloatingPointNumber)0;
-
-	long n = fprintf(f.in, fricasCmd, x);
-	if (n <= 0) {
-		return nan;
-	}
-	n = fflush(f.in);
-	if (n != 0) {
-		return nan;
-	}
-
 	// Skip "[^)]*)  ".
 	for (;;) {
 		int c = fgetc(f.out);
 		if (c < 0) {
-			return nan;
+			return nil;
 		}
 		if (c == ')') {
 			break;
 		}
 	}
+	long n;
 	for (n = 0; n < 2; n++) {
 		int c = fgetc(f.out);
 		if (c < 0) {
-			return nan;
+			return nil;
 		}
 	}
 
-	char num[60];
-	char *ss, *s = fgets(num, sizeof(num), f.out);
+	char *s = fgets(num, NumberBufferSize, f.out);
 	if (s == nil) {
-		return nan;
+		return nil;
 	}
 
 	s = num;
@@ -61,16 +59,116 @@ FricasFloatEval(FloatFricas f, const char *fricasCmd, ieee754FloatingPointNumber
 		s = &num[1];
 		s[0] = '-';
 	}
-	x = strtod(s, &ss);
+	return s;
+}
+
+// Reads the result of the last command sent to Fricas.
+static
+ieee754FloatingPointNumber
+readFloat(FloatFricas f) {
+	// TODO: Maybe return a custom NaN for each error?
+	const ieee754FloatingPointNumber nan = (ieee754FloatingPointNumber)0 / (ieee754FloatingPointNumber)0;
+
+	char num[NumberBufferSize];
+	char *ss, *s = readNumber(f, num);
+	if (s == nil) {
+		return nan;
+	}
+	ieee754FloatingPointNumber x = strtod(s, &ss);
 	if (ss == s) {
 		return nan;
 	}
 	return x;
 }
 
+ieee754FloatingPointNumber
+FricasFloatEval(FloatFricas f, const char *fricasCmd, ieee754FloatingPointNumber x) {
+	const ieee754FloatingPointNumber nan = (ieee754FloatingPointNumber)0 / (ieee754FloatingPointNumber)0;
+
+	long n = fprintf(f.in, fricasCmd, x);
+	if (n <= 0) {
+		return nan;
+	}
+	n = fflush(f.in);
+	if (n != 0) {
+		return nan;
+	}
+	return readFloat(f);
+}
+
+// Like FricasFloatEval, but fricasCmd is sent as is.
+ieee754FloatingPointNumber
+FricasEval(FloatFricas f, const char *fricasCmd) {
+	const ieee754FloatingPointNumber nan = (ieee754FloatingPointNumber)0 / (ieee754FloatingPointNumber)0;
+
+	if (fputs(fricasCmd, f.in) < 0 || fflush(f.in) != 0) {
+		return nan;
+	}
+	return readFloat(f);
+}
+
+// Like FricasFloatEval, for long double.
+long double
+FricasFloatEvalL(FloatFricas f, const char *fricasCmd, long double x) {
+	const long double nan = (long double)0 / (long double)0;
+
+	if (fprintf(f.in, fricasCmd, x) <= 0 || fflush(f.in) != 0) {
+		return nan;
+	}
+	char num[NumberBufferSize];
+	char *ss, *s = readNumber(f, num);
+	if (s == nil) {
+		return nan;
+	}
+	long double r = strtold(s, &ss);
+	if (ss == s) {
+		return nan;
+	}
+	return r;
+}
+
+#ifdef __FLT128_MANT_DIG__
+// Like FricasFloatEval, for _Float128. Printf does not know the type,
+// so x is passed to fricasCmd as a string, for a %s conversion.
+_Float128
+FricasFloatEvalQ(FloatFricas f, const char *fricasCmd, _Float128 x) {
+	const _Float128 nan = (_Float128)0 / (_Float128)0;
+
+	// 37 significant digits are enough to get x back from the decimal
+	// representation.
+	char arg[NumberBufferSize];
+	strfromf128(arg, sizeof(arg), "%.36e", x);
+	if (fprintf(f.in, fricasCmd, arg) <= 0 || fflush(f.in) != 0) {
+		return nan;
+	}
+	char num[NumberBufferSize];
+	char *ss, *s = readNumber(f, num);
+	if (s == nil) {
+		return nan;
+	}
+	_Float128 r = strtof128(s, &ss);
+	if (ss == s) {
+		return nan;
+	}
+	return r;
+}
+#endif
+
 FloatFricas
 FricasFloatNew(void) {
+	return FricasFloatNewDigits(FloatFricasDigits);
+}
+
+// Like FricasFloatNew, but with the given number of significant digits
+// in FriCAS's output, at most FloatFricasMaxDigits.
+FloatFricas
+FricasFloatNewDigits(int digits) {
 	FloatFricas r = {nil};
+	if (digits < 1 || FloatFricasMaxDigits < digits) {
+		return r;
+	}
+	char outputGeneral[40];
+	sprintf(outputGeneral, "outputGeneral(%d)$Float", digits);
 	int s;
 	int in[2], out[2];
 	s = pipe(in);
@@ -102,9 +200,9 @@ FricasFloatNew(void) {
 	if (s != 0) {
 		return r;
 	}
-	static char *const a[] = {"fricas", "-nosman", "-eval", ")set output algebra off", "-eval", ")lib )dir " FricasLibDir,
+	char *const a[] = {"fricas", "-nosman", "-eval", ")set output algebra off", "-eval", ")lib )dir " FricasLibDir,
 		"-eval", ")set history off", "-eval", ")set messages prompt none", "-eval", ")set messages type off",
-		"-eval", "bits(" FloatFricasBits ")$Float", "-eval", "outputGeneral(21)$Float", "-eval", "outputSpacing(0)$Float",
+		"-eval", "bits(" FloatFricasBits ")$Float", "-eval", outputGeneral, "-eval", "outputSpacing(0)$Float",
 		"-eval", ")set output algebra on", nil};
 	extern char **environ;
 	s = posix_spawnp(nil, "fricas", &fa, nil, a, environ);
@@ -11,6 +11,14 @@ enum {
 // Bits of precision for floating point representation.
 #define FloatFricasBits "32768"
 
+enum {
+	// Significant digits of FriCAS's output by default, and at most.
+	// 21 are enough to round trip double and x87 long double, 36 are
+	// needed for binary128.
+	FloatFricasDigits = 21,
+	FloatFricasMaxDigits = 40,
+};
+
 typedef double ieee754FloatingPointNumber;
 
 typedef struct {
@@ -18,5 +26,11 @@ typedef struct {
 } FloatFricas;
 
 ieee754FloatingPointNumber FricasFloatEval(FloatFricas, const char *, ieee754FloatingPointNumber);
+ieee754FloatingPointNumber FricasEval(FloatFricas, const char *);
+long double FricasFloatEvalL(FloatFricas, const char *, long double);
+#ifdef __FLT128_MANT_DIG__
+_Float128 FricasFloatEvalQ(FloatFricas, const char *, _Float128);
+#endif
 FloatFricas FricasFloatNew(void);
+FloatFricas FricasFloatNewDigits(int);
 int FricasClose(FloatFricas);
@@ -56,180 +56,574 @@
 // second tells one how much better or worse the new result is compared
 // to the old one. (The fscore is the same, but in relative terms.)
 //
+// Compile with CHECK_BINARY defined to get the report in a compact
+// binary form instead, see results/results.h; results/resprint renders
+// it into the text form. Compile with CHECK_STORE defined to get it as
+// a store, indexed for queries with results/resquery. Compile with
+// CHECK_COMPRESS defined to get the binary form compressed (link with
+// results/compress.c -lz); results/resunz decompresses it. In every
+// form, the report is written by the writer thread of a log (see
+// results/log.c), so that the sweep only encodes its records.
+//
+// The data of the sweep and of the report is allocated from an arena
+// (results/arena.c), released at once at the end, when its statistics
+// are printed to the standard error. Compile with CHECK_HUGE defined to
+// back it with transparent huge pages.
+//
+// Compile with CHECK_TOP defined (and link with results/top.c) to get a
+// last section, with the ResTopMax points of each function with the
+// best and the worst iscore, and the best and the worst fscore, kept
+// during the sweep. Compile with CHECK_HIST defined (and link with
+// results/hist.c) to end it with histograms of the ULP errors of the
+// old and the new values, for each function and binade of x, on a log
+// scale; without CHECK_HALF or CHECK_BF16 only the points with differing
+// old and new values are checked, the others only count in the totals.
+// results/resmerge merges these sections of the reports of the shards
+// of a sweep. Compile with CHECK_PYRAMID defined to end it with a
+// pyramid of the range statistics: the ranges summarized again for
+// every ResPyramidFactor of them, and so on for ResPyramidLevels levels,
+// so that results/resquery -m gives the statistics of wide intervals
+// from a few records.
+//
+// Compile with CHECK_SAMPLE defined to a seed, e.g. -DCHECK_SAMPLE=1,
+// to sample the whole domain instead of sweeping the fixed points:
+// SampleRanges ranges of points from each finite nonzero binade of each
+// sign (up to |x| < 2^30 for the kernels with the argument reduction of
+// sncs1cs, and 2^26 for tnct, which are not defined beyond, see
+// kernels.h), drawn uniformly over its bit patterns by xoshiro256**
+// and sorted, so the report is in the order of x, as for the other
+// sweeps. Every new value is verified, as for the narrow formats, and
+// the report ends with a section with, for each function, the numbers
+// of misrounded old and new values in each octant of x (of pi x for
+// CHECK_PI, and none for CHECK_EXP, CHECK_LOG and CHECK_HYP) of each
+// binade, with their estimated rates and 95% confidence intervals, then
+// the estimates for the whole domain, over all its bit patterns.
+//
 // The FriCAS computer algebra system is used for (hopefully) accurate
 // computation of values of the mathematical functions. (Ensure
 // 'fricas' is in PATH.)
+//
+// Compile with CHECK_HALF or CHECK_BF16 defined to instead check the
+// binary16 or bfloat16 versions exhaustively: every bit pattern is an
+// input, the old results are the libm double results rounded to the
+// format, and the accurate values (rounded to the format by FriCAS)
+// are gotten for every point, so that the new results can be verified
+// to be correctly rounded. The ones that are not get a "wrong" line in
+// the first section, and are counted after the last section. The
+// batch kernel is checked, and compared to the scalar one.
+//
+// Compile with CHECK_LDBL or CHECK_F128 defined to check the x87 long
+// double or the binary128 version on the same points, with the libm
+// functions for that type giving the old results, and with the
+// accurate values rounded to the type by FriCAS.
+//
+// Compile with one of these defined to check another double kernel
+// instead, against the corresponding libm functions:
+//
+// * CHECK_EXP: exexm1, for exp and expm1
+// * CHECK_LOG: lglg1p, for log and log1p
+// * CHECK_HYP: snhcshm1, for sinh, cosh and cosh-1
+// * CHECK_PI: sncs1cspi, for sin(pi x), cos(pi x) and 1-cos(pi x), with
+//   the old results computed by multiplying by pi first; the batch
+//   version is compared to the scalar one
+// * CHECK_TAN: tnct, for tan and cot, with the old cot being 1/tan(x);
+//   without CHECK_WIDE, half of the points are around the pole of tan
+//   at pi/2, the others start at that of cot at zero, after ranges of
+//   the tiny x: -0 and the negative subnormals, and those around the
+//   least normal value and 2^-997; the batch version is compared to the
+//   scalar one
+// * CHECK_HAV: versin and haversin, and hvdistBatch for the distance
+//   between (0, 0) and (x, x), with the old results from libm's sin and
+//   cos; the batch version is compared to the scalar one
+// * CHECK_CPLX: csncs and cxexp, for the real and imaginary parts of
+//   sin(z), cos(z) and exp(z) with z = x + x i, against csin, ccos and
+//   cexp; both batch versions are compared to the scalar one, and at a
+//   few points off the diagonal, where e^x, cosh or sinh overflow, the
+//   parts that are infinite but should not be, or the other way around,
+//   are printed to the standard error
 
-#include <math.h>
+#define __STDC_WANT_IEC_60559_TYPES_EXT__
+
+#include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <tgmath.h>
 
 #include <cfricas.h>
+#include <kernels.h>
+#include <results.h>
 
 typedef long int64;
 typedef unsigned long uint64;
 
 #define nil 0
 
+#if defined(CHECK_LDBL) || defined(CHECK_F128)
+#define CHECK_EXTENDED
+#endif
+
+#if defined(CHECK_LDBL)
+typedef long double mfloat_t;
+typedef sincos1cosl msincos1cos;
+
+enum {
+	// Stored significand bits, not counting the explicit integer bit.
+	ExtMantBits = 63,
+
+	FricasDigits = FloatFricasDigits,
+
+	ValueKind = ResValueLdbl,
+
+	// The exponents of the least subnormal and of the greatest finite
+	// values, for the binades of the histograms.
+	HistMinExp = -16445,
+	HistMaxExp = 16383,
+};
+
+// Significand bits and the exponent of the least subnormal, for
+// cnf_round.
+#define EXTFMT "64, -16445"
+
+#define FLTFMT "%28.20Le"
+
+#define msncs1cs sncs1csl
+#define mFricasFloatEval FricasFloatEvalL
+#elif defined(CHECK_F128)
+typedef _Float128 mfloat_t;
+typedef sincos1cosq msincos1cos;
+
+enum {
+	ExtMantBits = 112,
+
+	FricasDigits = 36,
+
+	ValueKind = ResValueF128,
+
+	HistMinExp = -16494,
+	HistMaxExp = 16383,
+};
+
+#define EXTFMT "113, -16494"
+
+// Printf does not know _Float128, so FriCAS gets its values as
+// strings, see FricasFloatEvalQ.
+#define FLTFMT "%44s"
+
+#define msncs1cs sncs1csq
+#define mFricasFloatEval FricasFloatEvalQ
+#else
 typedef double mfloat_t;
-typedef int mint_t;
-
-/* The following code (sincos1cos and float and double versions of
- * sncs1cs) is Copyright © 1985, 1995, 2000 Stephen L. Moshier and
- * Copyright © 2020 Neven Sajko. The intention is to get accurate
- * 1-cosine, while also getting the sine and cosine as a bonus. The
- * implementation is derived from the Cephes Math Library's sin.c and
- * sinf.c. To be more specific, I took Stephen Moshier's sin, cos, sinf
- * and cosf (without changing the polynomials) and adapted them to give
- * all three required function values (in double and float versions),
- * without unnecessary accuracy losses.
- *
- * sncs1cs is not correct for values of x of huge magnitude. That can
- * be fixed by more elaborate range reduction.
- */
+typedef sincos1cos msincos1cos;
 
-typedef struct {
-	/* Sine, cosine, 1-cosine */
-	mfloat_t sin, cos, omc;
-} sincos1cos;
+enum {
+	FricasDigits = FloatFricasDigits,
 
-static
-sincos1cos
-sncs1cs(mfloat_t x) {
-	const mfloat_t fourOverPi = 1.27323954473516268615;
+	ValueKind = ResValueDouble,
 
-	mfloat_t y, z, zz;
-	mint_t j, sign = 1, csign = 1;
-	sincos1cos r;
-
-	/* Handle +-0. */
-	if (x == (mfloat_t)0) {
-		r.sin = x;
-		r.cos = 1;
-		r.omc = 0;
-		return r;
-	}
-	if (isnan(x)) {
-		r.sin = r.cos = r.omc = x;
-		return r;
-	}
-	if (isinf(x)) {
-		r.sin = r.cos = r.omc = x - x;
-		return r;
-	}
-	if (x < 0) {
-		sign = -1;
-		x = -x;
-	}
-	j = (mint_t)(x * fourOverPi);
-	y = (mfloat_t)j;
-	/* map zeros to origin */
-	if ((j & 1)) {
-		j += 1;
-		y += 1;
-	}
-	j = j & 7; /* octant modulo one turn */
-	/* reflect in x axis */
-	if (j > 3) {
-		sign = -sign;
-		csign = -csign;
-		j -= 4;
-	}
-	if (j > 1) {
-		csign = -csign;
-	}
-
-	const double sc[] = {
-		1.58962301576546568060E-10,
-		-2.50507477628578072866E-8,
-		2.75573136213857245213E-6,
-		-1.98412698295895385996E-4,
-		8.33333333332211858878E-3,
-		-1.66666666666666307295E-1,
-	};
+	HistMinExp = -1074,
+	HistMaxExp = 1023,
+};
 
-	const double cc[] = {
-		-1.13585365213876817300E-11,
-		2.08757008419747316778E-9,
-		-2.75573141792967388112E-7,
-		2.48015872888517045348E-5,
-		-1.38888888888730564116E-3,
-		4.16666666666665929218E-2,
-	};
+#define FLTFMT "%27.20e"
 
-	const double DP1 = 7.85398125648498535156E-1;
-	const double DP2 = 3.77489470793079817668E-8;
-	const double DP3 = 2.69515142907905952645E-15;
+#define msncs1cs sncs1cs
+#define mFricasFloatEval fricasEvalAt
+#endif
 
-	/* Extended precision modular arithmetic */
-	z = ((x - y * DP1) - y * DP2) - y * DP3;
-	zz = z * z;
-	r.sin = z + zz*z*(((((sc[0]*zz + sc[1])*zz + sc[2])*zz + sc[3])*zz + sc[4])*zz + sc[5]);
-	r.omc = (mfloat_t)0.5*zz - zz*zz*(((((cc[0]*zz + cc[1])*zz + cc[2])*zz + cc[3])*zz + cc[4])*zz + cc[5]);
+#if defined(CHECK_HALF) || defined(CHECK_BF16)
+#define CHECK_NARROW
+#endif
 
-	if (j == 1 || j == 2) {
-		if (csign < 0) {
-			r.sin = -r.sin;
-		}
-		r.cos = r.sin;
-		r.sin = 1 - r.omc;
-		r.omc = 1 - r.cos;
-	} else {
-		if (csign < 0) {
-			r.cos = r.omc - 1;
-			r.omc = 1 - r.cos;
-		} else {
-			r.cos = 1 - r.omc;
-		}
-	}
-	if (sign < 0) {
-		r.sin = -r.sin;
-	}
-	return r;
+// Checking a kernel other than sncs1cs.
+#if defined(CHECK_EXP) || defined(CHECK_LOG) || defined(CHECK_HYP) || defined(CHECK_PI) || defined(CHECK_TAN) || defined(CHECK_HAV) || defined(CHECK_CPLX)
+#define CHECK_FAMILY
+#endif
+
+#if defined(CHECK_BINARY) + defined(CHECK_STORE) + defined(CHECK_COMPRESS) > 1
+#error "CHECK_BINARY, CHECK_STORE and CHECK_COMPRESS select different outputs"
+#endif
+
+#if defined(CHECK_FAMILY) && (defined(CHECK_NARROW) || defined(CHECK_EXTENDED))
+#error "the kernels other than sncs1cs are checked in double only"
+#endif
+
+#if defined(CHECK_SAMPLE) && (defined(CHECK_NARROW) || defined(CHECK_EXTENDED))
+#error "the sampling sweep is for double; the narrow formats are checked exhaustively"
+#endif
+
+// All new values are verified, not just the changed ones.
+#if defined(CHECK_NARROW) || defined(CHECK_SAMPLE)
+#define CHECK_VERIFY
+#endif
+
+#if defined(CHECK_HALF)
+enum {
+	// Stored significand bits
+	NarrowMantBits = 10,
+};
+
+// Significand bits and the exponent of the least subnormal, for
+// cnf_round.
+#define NARROWFMT "11, -24"
+
+#define narrowFromDouble halfFromDouble
+#define narrowScalar sncs1csh
+#define narrowBatch sncs1cshBatch
+
+static
+mfloat_t
+narrowToDouble(uint16_t x) {
+	return halfToFloat(x);
+}
+#elif defined(CHECK_BF16)
+enum {
+	NarrowMantBits = 7,
+};
+
+#define NARROWFMT "8, -133"
+
+#define narrowFromDouble bf16FromDouble
+#define narrowScalar sncs1csb
+#define narrowBatch sncs1csbBatch
+
+static
+mfloat_t
+narrowToDouble(uint16_t x) {
+	return bf16ToFloat(x);
 }
+#endif
 
+#if defined(CHECK_EXP)
+enum {
+	expIndex,
+	em1Index,
+	FuncLimit,
+};
+#elif defined(CHECK_LOG)
+enum {
+	logIndex,
+	l1pIndex,
+	FuncLimit,
+};
+#elif defined(CHECK_HYP)
+enum {
+	snhIndex,
+	cshIndex,
+	cm1Index,
+	FuncLimit,
+};
+#elif defined(CHECK_PI)
+enum {
+	snpIndex,
+	cspIndex,
+	ompIndex,
+	FuncLimit,
+};
+#elif defined(CHECK_TAN)
+enum {
+	tanIndex,
+	cotIndex,
+	FuncLimit,
+};
+#elif defined(CHECK_HAV)
+enum {
+	vrsIndex,
+	hvsIndex,
+	hvdIndex,
+	FuncLimit,
+};
+#elif defined(CHECK_CPLX)
+enum {
+	sreIndex,
+	simIndex,
+	creIndex,
+	cimIndex,
+	ereIndex,
+	eimIndex,
+	FuncLimit,
+};
+#else
 enum {
 	sinIndex,
 	cosIndex,
 	omcIndex,
 	FuncLimit,
+};
+#endif
 
+enum {
 	PointsInOneRange = 32,
+
+	// Enough for a command to FriCAS, with its argument.
+	FricasCmdBytes = 256,
+
+#ifdef CHECK_HUGE
+	ArenaHuge = 1,
+#else
+	ArenaHuge = 0,
+#endif
 };
 
-#define FLTFMT "%27.20e"
+#ifdef CHECK_SAMPLE
+enum {
+	// The greatest exponent of the binades that are sampled: for the
+	// kernels with the argument reduction of sncs1cs, which converts
+	// the octant to an int, that of their domain, |x| < 2^30, or
+	// |x| < 2^26 for tnct (see kernels.h), and for the others, that of
+	// the greatest finite values.
+#if defined(CHECK_EXP) || defined(CHECK_LOG) || defined(CHECK_HYP) || defined(CHECK_PI)
+	SampleMaxExp = HistMaxExp,
+#elif defined(CHECK_TAN)
+	SampleMaxExp = 25,
+#else
+	SampleMaxExp = 29,
+#endif
+
+	// The strata: the nonzero binades of each sign, up to that of
+	// SampleMaxExp, in the order of value, with the points of
+	// SampleRanges ranges drawn from each.
+	SampleBinades = SampleMaxExp - HistMinExp + 1,
+	SampleStrata = 2*SampleBinades,
+	SampleRanges = 1,
+	SamplePoints = SampleRanges*PointsInOneRange,
+
+	// Stored significand bits, and the exponent of the least normal
+	// values.
+	SampleMantBits = 52,
+	SampleMinNormExp = -1022,
+
+	// The octants of x, for the periodic functions.
+#if defined(CHECK_EXP) || defined(CHECK_LOG) || defined(CHECK_HYP)
+	SampleOctants = 1,
+#else
+	SampleOctants = ResSampleOctants,
+#endif
+};
+#endif
 
 #define TMPLT "(" FLTFMT ")$CNF\n"
 
+#if defined(CHECK_EXP)
+static const char *const funcNames[] = {"exp", "em1"};
+static const char *const fricasFuncNames[] = {"cnf_exp" TMPLT, "cnf_expm1" TMPLT};
+#elif defined(CHECK_LOG)
+static const char *const funcNames[] = {"log", "l1p"};
+static const char *const fricasFuncNames[] = {"cnf_log" TMPLT, "cnf_log1p" TMPLT};
+#elif defined(CHECK_HYP)
+static const char *const funcNames[] = {"snh", "csh", "cm1"};
+static const char *const fricasFuncNames[] = {"cnf_sinh" TMPLT, "cnf_cosh" TMPLT, "cnf_coshm1" TMPLT};
+#elif defined(CHECK_PI)
+static const char *const funcNames[] = {"snp", "csp", "omp"};
+static const char *const fricasFuncNames[] = {"cnf_sinpi" TMPLT, "cnf_cospi" TMPLT, "cnf_1cspi" TMPLT};
+#elif defined(CHECK_TAN)
+static const char *const funcNames[] = {"tan", "cot"};
+static const char *const fricasFuncNames[] = {"cnf_tan" TMPLT, "cnf_cot" TMPLT};
+#elif defined(CHECK_HAV)
+static const char *const funcNames[] = {"vrs", "hvs", "hvd"};
+static const char *const fricasFuncNames[] = {"cnf_versin" TMPLT, "cnf_haversin" TMPLT, "cnf_hvdist" TMPLT};
+#elif defined(CHECK_CPLX)
+#define CTMPLT(f) "cnf_cdiag(\"" f "\", " FLTFMT ")$CNF\n"
+static const char *const funcNames[] = {"sre", "sim", "cre", "cim", "ere", "eim"};
+static const char *const fricasFuncNames[] = {CTMPLT("sre"), CTMPLT("sim"), CTMPLT("cre"), CTMPLT("cim"), CTMPLT("ere"), CTMPLT("eim")};
+#elif defined(CHECK_NARROW)
+#define NTMPLT(f) "cnf_round(" f "(" FLTFMT ")$CNF, " NARROWFMT ")$CNF\n"
+static const char *const funcNames[] = {"sin", "cos", "omc"};
+static const char *const fricasFuncNames[] = {NTMPLT("cnf_sin"), NTMPLT("cnf_cos"), NTMPLT("cnf_1cs")};
+#elif defined(CHECK_EXTENDED)
+#define ETMPLT(f) f "(" FLTFMT ", " EXTFMT ")$CNF\n"
+static const char *const funcNames[] = {"sin", "cos", "omc"};
+static const char *const fricasFuncNames[] = {ETMPLT("cnf_sin"), ETMPLT("cnf_cos"), ETMPLT("cnf_1cs")};
+#else
 static const char *const funcNames[] = {"sin", "cos", "omc"};
 static const char *const fricasFuncNames[] = {"cnf_sin" TMPLT, "cnf_cos" TMPLT, "cnf_1cs" TMPLT};
+#endif
 
+#ifndef CHECK_NARROW
 static const mfloat_t posInf = 1.0/0.0;
+#endif
+
+// Whether x is in the domain of the function with index fn, as far as
+// FriCAS is concerned. Outside of it, the old result is taken as the
+// accurate one.
+static
+int
+inDomain(int fn, mfloat_t x) {
+#if defined(CHECK_LOG)
+	if (fn == logIndex) {
+		return 0 < x && isfinite(x);
+	}
+	return -1 < x && isfinite(x);
+#elif defined(CHECK_TAN)
+	return (fn != cotIndex || x != 0) && isfinite(x);
+#else
+	(void)fn;
+	return isfinite(x);
+#endif
+}
 
 typedef struct {
 	mfloat_t old, new, accurate;
 } funcVal;
 
+// The kept points of a function in the current range: only those with
+// differing old and new values (all of them, for the exhaustive checks),
+// with a column of each kind of value, so that scoring them streams
+// through the values of one kind.
+typedef struct {
+	mfloat_t old[PointsInOneRange], new[PointsInOneRange], accurate[PointsInOneRange];
+	int n;
+} pointColumns;
+
+// The range being checked. Its points are added to the report as soon
+// as it is done, so nothing of it is kept after that.
 typedef struct {
-	funcVal a[PointsInOneRange][FuncLimit];
 	mfloat_t limits[2];
+	pointColumns points[FuncLimit];
 } Range;
 
+typedef struct {
+	int count;
+	int64 max;      // max integer (absolute) score
+	mfloat_t maxScor; // max floating point (relative) score
+	mfloat_t mean2;   // quadratic mean of the relative scores
+} microReport;
+
+// For making the final report, represents a range of consecutive IEEE 754 numbers.
+typedef struct {
+	// unordered set containing the max and min input values
+	mfloat_t limits[2];
+
+	microReport improvements, worsenings;
+
+	// arithmetic mean of the relative scores
+	mfloat_t mean1;
+} rangeReport;
+
+// The reports of the ranges with changes of a function.
+typedef struct {
+	rangeReport *p;
+	int i, cap;
+} rangeSlice;
+
+#ifdef CHECK_SAMPLE
+// The tally of the points of a function in an octant of a binade: all
+// of them, and those whose old and new values are not correctly
+// rounded.
+typedef struct {
+	int64 total, wrong[2];
+} sampleCell;
+#endif
+
+#ifdef CHECK_HIST
+enum {
+	// Binades of each sign: one for each exponent, one for the zero,
+	// and one for the infinity and NaN.
+	HistBinades = HistMaxExp - HistMinExp + 3,
+};
+
+// The histograms of the old and of the new values of a binade.
+typedef struct {
+	// The lowest value of the binade: +-2^e, +-0, or the first
+	// infinity or NaN.
+	mfloat_t low;
+	int64 total;
+	int64 counts[2][ResHistBuckets];
+} binadeHist;
+#endif
+
 typedef struct {
 	// Interface to FriCAS
 	FloatFricas fr;
 
-	// Slice of ranges of points.
-	Range *funcData;
+	// The current range, and its index.
+	Range range;
 	int i;
+
+	// The reports of the ranges of each function, built range by
+	// range during the sweep.
+	rangeSlice byFunction[FuncLimit];
+#ifdef CHECK_PYRAMID
+	// The nodes of each level of the pyramid of each function: node j
+	// of level l + 1 has the span[l] ranges from j*span[l] on.
+	rangeReport *pyramid[FuncLimit][ResPyramidLevels];
+	int span[ResPyramidLevels], nodes[ResPyramidLevels];
+#endif
+
+	// The memory of the sweep and of the report, released at the end.
+	ResArena *arena;
+
+#ifdef CHECK_VERIFY
+	// Counts of new values that are not correctly rounded.
+	long misrounded[FuncLimit];
+#endif
+#ifdef CHECK_SAMPLE
+	// The state of the generator of the samples; the samples of the
+	// current binade, in increasing order, and their number; the
+	// number of points sampled so far; and the tallies of each
+	// function, binade and octant.
+	uint64 rng[4];
+	mfloat_t samples[SamplePoints];
+	int nsamples;
+	long sampled;
+	sampleCell *cells;
+#endif
+
+	// The report, in the binary form, in a store, compressed, or
+	// rendered into the text form, by the writer thread of the log.
+	ResLog *log;
+	ResHeader h;
+	ResText text;
+#ifdef CHECK_STORE
+	ResStoreWriter store;
+#endif
+#ifdef CHECK_COMPRESS
+	ResZWriter *z;
+#endif
+
+#ifdef CHECK_TOP
+	// ResTopLists heaps for each function.
+	ResTopHeap *top;
+#endif
+#ifdef CHECK_HIST
+	// 2*HistBinades histograms for each function, allocated when a
+	// point falls in their binade.
+	binadeHist **hist;
+#endif
 } dat;
 
+#ifndef CHECK_VERIFY
 static
 int
 interesting(long d) {
 	return d != 0;
 }
+#endif
+
+#ifdef CHECK_EXTENDED
+// The position of x among the values of its type: consecutive values
+// have consecutive positions, and both zeros are at 0.
+static
+__int128
+extOrd(mfloat_t x) {
+#if defined(CHECK_LDBL)
+	// The integer bit is explicit, and set just for the normal
+	// numbers, so positions follow from leaving it out.
+	uint64 m;
+	unsigned short se;
+	memcpy(&m, &x, sizeof(m));
+	memcpy(&se, (char *)&x + sizeof(m), sizeof(se));
+	__int128 r = (__int128)(se & 0x7fff) << ExtMantBits | (m & ~0UL >> 1);
+	return (se & 0x8000) ? -r : r;
+#else
+	unsigned __int128 u;
+	memcpy(&u, &x, sizeof(u));
+	__int128 r = (__int128)(u & ~((unsigned __int128)1 << 127));
+	return (u >> 127) ? -r : r;
+#endif
+}
+#endif
 
 // ULP distance. Distance between 0.0 and -0.0 is taken to be 0.
 //
@@ -243,63 +637,94 @@ ud(mfloat_t x, mfloat_t y) {
 		return (int64)(~0UL >> 1);
 	}
 
+#if defined(CHECK_EXTENDED)
+	__int128 d = extOrd(x) - extOrd(y);
+	if (d < 0) {
+		d = -d;
+	}
+	if ((__int128)(~0UL >> 1) < d) {
+		return (int64)(~0UL >> 1);
+	}
+	return (int64)d;
+#else
+#if defined(CHECK_NARROW)
+	// The values are from the narrow format, so count its ULPs.
+	uint64 a = narrowFromDouble(x), b = narrowFromDouble(y);
+	const uint64 signBit = 1UL << 15;
+#else
 	union {mfloat_t X; uint64 a;} u1;
 	union {mfloat_t Y; uint64 b;} u2;
 	u1.X = x;
 	u2.Y = y;
 	uint64 a = u1.a, b = u2.b;
+	const uint64 signBit = 1UL << 63;
+#endif
 
-	if ((a & (1UL << 63)) == (b & (1UL << 63))) {
-		// a and b are of the same sign.
-		a = a - b;
-		if ((a & (1UL << 63))) {
-			return -a;
-		}
-		return a;
-	}
-	return (int64)(a - (1UL << 63) + b);
+	// Both distances are computed and one is selected, so that the
+	// function has no branches and loops over it can be vectorised.
+	// Same signs: the difference of the magnitudes; otherwise their sum.
+	uint64 d = a - b, same = (int64)d < 0 ? -d : d;
+	return (int64)((a ^ b) & signBit ? a - signBit + b : same);
+#endif
 }
 
+// ResBetter or ResWorse, or 0 when the difference is not significant.
 static
-const char *
+int
 quiteInteresting(funcVal v) {
 	int64 ac = ud(v.old, v.accurate), bc = ud(v.new, v.accurate);
 	const mfloat_t L = 1e-7; // Needs to be positive and close to zero.
 	if ((mfloat_t)(ac - bc)/(mfloat_t)(bc) > L) {
-		return "better";
+		return ResBetter;
 	}
 	if ((mfloat_t)(bc - ac)/(mfloat_t)(ac) > L) {
-		return "worse ";
+		return ResWorse;
 	}
-	return nil;
+	return 0;
 }
 
+// The position of the highest significand bit in which old and new
+// differ, or 0 if their signs or exponents differ.
 static
-void
-about(mfloat_t old, mfloat_t new, char *r) {
+int
+about(mfloat_t old, mfloat_t new) {
+#if defined(CHECK_EXTENDED)
+	__int128 oldO = extOrd(old), newO = extOrd(new);
+	__int128 oldM = oldO < 0 ? -oldO : oldO, newM = newO < 0 ? -newO : newO;
+	if (signbit(old) != signbit(new) || oldM >> ExtMantBits != newM >> ExtMantBits) {
+		return 0;
+	}
+
+	unsigned __int128 d = oldM < newM ? newM - oldM : oldM - newM;
+#else
+#if defined(CHECK_NARROW)
+	uint64 oldI = narrowFromDouble(old), newI = narrowFromDouble(new);
+	const uint64 signExpMask = 0xffffUL & ~0UL << NarrowMantBits;
+#else
 	union {mfloat_t oldF; uint64 oldI;} u1;
 	union {mfloat_t newF; uint64 newI;} u2;
 	u1.oldF = old;
 	u2.newF = new;
-	if (((u1.oldI ^ u2.newI) & 0xfff0000000000000UL)) {
-		sprintf(r, "Exponents or signs differ !");
-		return;
+	uint64 oldI = u1.oldI, newI = u2.newI;
+	const uint64 signExpMask = 0xfff0000000000000UL;
+#endif
+	if (((oldI ^ newI) & signExpMask)) {
+		return 0;
 	}
 
-	int64 d = (int64)(u1.oldI - u2.newI);
+	int64 d = (int64)(oldI - newI);
 	if (d < 0) {
 		d = -d;
 	}
-	// Floor of the binary logarithm AKA position of the MSB.
-	int n;
-	for (n = 1;; n++) {
-		d >>= 1;
-		if (d == 0) {
-			break;
-		}
+#endif
+	// Floor of the binary logarithm AKA position of the MSB, counting
+	// from 1; 1 also when old and new are equal.
+#if defined(CHECK_EXTENDED)
+	if ((uint64)(d >> 64) != 0) {
+		return 128 - __builtin_clzl((uint64)(d >> 64));
 	}
-
-	sprintf(r, "Mantissas differ in %2d bits", n);
+#endif
+	return (uint64)d < 2 ? 1 : 64 - __builtin_clzl((uint64)d);
 }
 
 typedef struct {
@@ -307,6 +732,7 @@ typedef struct {
 	mfloat_t fscor;
 } ifscor;
 
+#ifdef CHECK_TOP
 static
 ifscor
 scoresOf(funcVal v) {
@@ -315,183 +741,1004 @@ scoresOf(funcVal v) {
 	r.fscor = (mfloat_t)r.iscor / (mfloat_t)bc;
 	return r;
 }
+#endif
 
+#if defined(CHECK_VERIFY) || defined(CHECK_PI) || defined(CHECK_TAN) || defined(CHECK_HAV) || defined(CHECK_CPLX)
+// Equality, except that NaNs are equal to each other.
 static
 int
-isNull(funcVal v) {
-	return v.old == v.new;
+sameValue(mfloat_t x, mfloat_t y) {
+	return x == y || x != x && y != y;
 }
+#endif
 
-// Record all interesting differences between old and new values of
-// mathematical functions.
+// The integer scores of the kept points of the range r for function fn,
+// and the distances of their new values from the accurate ones, in the
+// order of the points. Returns their number. The points are contiguous
+// in the columns, so the loop streams, and can be vectorised.
 static
-void
-checkSinCosOmcInPoint(dat *data, int pointInRange, mfloat_t x) {
-	funcVal a[FuncLimit] = {{sin(x), 0, 0}, {cos(x), 0, 0}, {0, 0, 0}};
-	a[omcIndex].old = 1 - a[cosIndex].old;
-	sincos1cos sc1c = sncs1cs(x);
-	a[sinIndex].new = sc1c.sin;
-	a[cosIndex].new = sc1c.cos;
-	a[omcIndex].new = sc1c.omc;
-
+int
+scoreRange(const Range *r, int fn, int64 iscor[PointsInOneRange], int64 bc[PointsInOneRange]) {
+	const pointColumns *c = &r->points[fn];
 	int i;
-	funcVal *funcData = data->funcData[data->i].a[pointInRange];
-	for (i = 0; i < FuncLimit; i++) {
-		const char *const f = "%6s " FLTFMT " %3s: %30s %22ld " FLTFMT " " FLTFMT " " FLTFMT "\n";
-		int64 diff = ud(a[i].old, a[i].new);
-		if (interesting(diff)) {
-			funcData[i] = a[i];
-			funcData[i].accurate = FricasFloatEval(data->fr, fricasFuncNames[i], x);
-			const char *s = quiteInteresting(funcData[i]);
-			if (s != nil) {
-				char buf[30];
-				about(funcData[i].old, funcData[i].new, buf);
-				printf(f, s, x, funcNames[i], buf, diff, funcData[i].old, funcData[i].new, funcData[i].accurate);
-			}
-		}
+	for (i = 0; i < c->n; i++) {
+		bc[i] = ud(c->new[i], c->accurate[i]);
+		iscor[i] = ud(c->old[i], c->accurate[i]) - bc[i];
 	}
+	return c->n;
 }
 
-// Check mathematical functions in PointsInOneRange points after and
-// including x.
+#if defined(CHECK_TOP) || defined(CHECK_HIST) || defined(CHECK_PYRAMID) || defined(CHECK_SAMPLE)
+// Zeroed memory from the arena of the run.
 static
-void
-testRange(dat *data, mfloat_t x) {
-	data->funcData[data->i].limits[0] = x;
-	int i;
-	for (i = 0; i < PointsInOneRange; i++) {
-		checkSinCosOmcInPoint(data, i, x);
-		x = nextafter(x, posInf);
+void *
+alloc(dat *data, size_t n) {
+	void *p = resArenaAlloc(data->arena, n);
+	if (p == nil) {
+		fprintf(stderr, "sinCosOmcTester: out of memory\n");
+		exit(1);
 	}
-	data->funcData[data->i].limits[1] = x;
+	return p;
 }
+#endif
 
-typedef struct {
-	int count;
-	int64 max;      // max integer (absolute) score
-	mfloat_t maxScor; // max floating point (relative) score
-	mfloat_t mean2;   // quadratic mean of the relative scores
-} microReport;
-
-// For making the final report, represents a range of consecutive IEEE 754 numbers.
-typedef struct {
-	// unordered set containing the max and min input values
-	mfloat_t limits[2];
-
-	microReport improvements, worsenings;
-
-	// arithmetic mean of the relative scores
-	mfloat_t mean1;
-} rangeReport;
+// Grows the array at p, of n bytes, to m bytes.
+static
+void *
+grow(dat *data, void *p, size_t n, size_t m) {
+	if ((p = resArenaGrow(data->arena, p, n, m)) == nil) {
+		fprintf(stderr, "sinCosOmcTester: out of memory\n");
+		exit(1);
+	}
+	return p;
+}
 
+// Appends the values of a point of the current range to the kept
+// points of function fn.
 static
 void
-updateMicroReport(microReport *r, int64 iS, mfloat_t fS) {
-	r->count++;
-	r->mean2 += fS * fS;
-	if (0 <= iS && r->max < iS || iS <= 0 && iS <= r->max) {
-		r->max = iS;
-	}
-	if (copysign(r->maxScor, (mfloat_t)1) < copysign(fS, (mfloat_t)1)) {
-		r->maxScor = fS;
-	}
+keepPoint(dat *data, int fn, const funcVal *v) {
+	pointColumns *c = &data->range.points[fn];
+	c->old[c->n] = v->old;
+	c->new[c->n] = v->new;
+	c->accurate[c->n] = v->accurate;
+	c->n++;
 }
 
+// Writes r to stdout, in one of the forms. Called on the writer thread
+// of the log.
+static
 int
-main(void) {
-#ifdef CHECK_WIDE
-	// Check for regressions.
+sink(void *arg, const ResRecord *r) {
+	dat *data = arg;
+#if defined(CHECK_BINARY)
+	return resWrite(stdout, &data->h, r);
+#elif defined(CHECK_STORE)
+	return resStoreAdd(&data->store, r);
+#elif defined(CHECK_COMPRESS)
+	return resZWrite(data->z, r);
+#else
+	resText(&data->text, stdout, r);
+	return 0;
+#endif
+}
+
+static
+void
+report(dat *data, const ResRecord *r) {
+	if (resLog(data->log, r)) {
+		fprintf(stderr, "sinCosOmcTester: failed to write the report\n");
+		exit(1);
+	}
+}
+
+static
+void
+reportPoint(dat *data, int status, mfloat_t x, int fn, int64 diff, const funcVal *v) {
+	ResRecord r = {ResPoint, fn, status, about(v->old, v->new), diff};
+	resSetValue(&data->h, r.v[ResX], &x);
+	resSetValue(&data->h, r.v[ResOld], &v->old);
+	resSetValue(&data->h, r.v[ResNew], &v->new);
+	resSetValue(&data->h, r.v[ResAccurate], &v->accurate);
+	report(data, &r);
+}
+
+#ifdef CHECK_TOP
+// Offers the point to the top lists of its function.
+static
+void
+keepTop(dat *data, mfloat_t x, int fn, const funcVal *v) {
+	ifscor s = scoresOf(*v);
+	if (s.iscor == 0) {
+		return;
+	}
+	ResRecord r = {ResTop, fn, 0 < s.iscor ? ResTopBestI : ResTopWorstI, 0, s.iscor};
+	resSetValue(&data->h, r.v[ResX], &x);
+	resSetValue(&data->h, r.v[ResOld], &v->old);
+	resSetValue(&data->h, r.v[ResNew], &v->new);
+	resSetValue(&data->h, r.v[ResAccurate], &v->accurate);
+	resSetValue(&data->h, r.v[ResScore], &s.fscor);
+	resTopAdd(&data->h, &data->top[fn*ResTopLists + r.status], &r);
+	r.status = 0 < s.iscor ? ResTopBestF : ResTopWorstF;
+	resTopAdd(&data->h, &data->top[fn*ResTopLists + r.status], &r);
+}
+#endif
+
+#ifdef CHECK_HIST
+// The index of the binade of x, in the order of value.
+static
+int
+binadeOf(mfloat_t x) {
+	int k = x == 0 ? 0 : isfinite(x) ? ilogb(x) - HistMinExp + 1 : HistBinades - 1;
+	return signbit(x) ? HistBinades - 1 - k : HistBinades + k;
+}
+
+// Counts the point in the histograms of its function, with its errors
+// if it was checked against the accurate value.
+static
+void
+keepHist(dat *data, mfloat_t x, int fn, const funcVal *v, int checked) {
+	binadeHist **p = &data->hist[fn*2*HistBinades + binadeOf(x)];
+	if (*p == nil) {
+		*p = alloc(data, sizeof(**p));
+		(*p)->low = x == 0 || !isfinite(x) ? x : copysign(ldexp((mfloat_t)1, ilogb(x)), x);
+	}
+	binadeHist *b = *p;
+	b->total++;
+	if (checked) {
+		b->counts[ResHistOld][resHistBucket((uint64)ud(v->old, v->accurate))]++;
+		b->counts[ResHistNew][resHistBucket((uint64)ud(v->new, v->accurate))]++;
+	}
+}
+#endif
+
+#ifdef CHECK_SAMPLE
+// The next number of splitmix64, which seeds the generator.
+static
+uint64
+splitMix(uint64 *x) {
+	uint64 z = *x += 0x9e3779b97f4a7c15UL;
+	z = (z ^ z >> 30) * 0xbf58476d1ce4e5b9UL;
+	z = (z ^ z >> 27) * 0x94d049bb133111ebUL;
+	return z ^ z >> 31;
+}
+
+static
+void
+seedSamples(dat *data, uint64 seed) {
+	int i;
+	for (i = 0; i < 4; i++) {
+		data->rng[i] = splitMix(&seed);
+	}
+}
+
+// The next number of xoshiro256**.
+static
+uint64
+nextRandom(dat *data) {
+	uint64 *s = data->rng, r = s[1] * 5, t = s[1] << 17;
+	r = (r << 7 | r >> 57) * 9;
+	s[2] ^= s[0];
+	s[3] ^= s[1];
+	s[1] ^= s[2];
+	s[0] ^= s[3];
+	s[2] ^= t;
+	s[3] = s[3] << 45 | s[3] >> 19;
+	return r;
+}
+
+// The bit pattern of the least magnitude of the binade of stratum s,
+// and the number of the low bits that vary in the binade.
+static
+uint64
+binadeBits(int s, int *w) {
+	int e = s < SampleBinades ? SampleMaxExp - s : HistMinExp + s - SampleBinades;
+	if (e < SampleMinNormExp) {
+		*w = e - HistMinExp;
+		return 1UL << *w;
+	}
+	*w = SampleMantBits;
+	return (uint64)(e - SampleMinNormExp + 1) << SampleMantBits;
+}
+
+// The value of the bit pattern of a magnitude in stratum s.
+static
+mfloat_t
+sampleValue(int s, uint64 bits) {
+	mfloat_t x;
+	memcpy(&x, &bits, sizeof(x));
+	return s < SampleBinades ? -x : x;
+}
+
+// The octant of x: floor(|x|/(pi/4)) modulo 8, as the reduction of the
+// kernel computes it, in double, for the sampled binades, or of pi x
+// for the CHECK_PI functions, exactly for any x.
+static
+int
+octantOf(mfloat_t x) {
+#if defined(CHECK_EXP) || defined(CHECK_LOG) || defined(CHECK_HYP)
+	(void)x;
+	return 0;
+#elif defined(CHECK_PI)
+	return (int)(4*fmod(fabs(x), 2));
+#else
+	const mfloat_t fourOverPi = 1.27323954473516268615;
+	return (int)(fabs(x)*fourOverPi) & 7;
+#endif
+}
+#endif
+
+#if !defined(CHECK_EXTENDED)
+// Like FricasFloatEval, but with x formatted by resFormatDouble, which
+// is much faster than printf, into the command template's FLTFMT.
+static
+mfloat_t
+fricasEvalAt(FloatFricas fr, const char *tmplt, mfloat_t x) {
+	char cmd[FricasCmdBytes];
+	const char *p = strstr(tmplt, FLTFMT);
+	size_t n = (size_t)(p - tmplt);
+	memcpy(cmd, tmplt, n);
+	n += (size_t)resFormatDouble(x, &cmd[n]);
+	strcpy(&cmd[n], p + strlen(FLTFMT));
+	return FricasEval(fr, cmd);
+}
+#endif
+
+// Record all interesting differences between old and new values of
+// mathematical functions.
+static
+void
+recordPoint(dat *data, mfloat_t x, const funcVal a[FuncLimit]) {
+	int i;
+	for (i = 0; i < FuncLimit; i++) {
+		int64 diff = ud(a[i].old, a[i].new);
+		funcVal v = a[i];
+#ifdef CHECK_VERIFY
+		// All new values are verified, not just the changed ones.
+		v.accurate = inDomain(i, x) ? mFricasFloatEval(data->fr, fricasFuncNames[i], x) : a[i].old;
+		int s = quiteInteresting(v);
+		if (!sameValue(v.new, v.accurate)) {
+			data->misrounded[i]++;
+			s = ResWrong;
+		}
+#ifdef CHECK_SAMPLE
+		sampleCell *c = &data->cells[(i*SampleStrata + data->i/SampleRanges)*SampleOctants + octantOf(x)];
+		c->total++;
+		c->wrong[ResHistOld] += !sameValue(v.old, v.accurate);
+		c->wrong[ResHistNew] += !sameValue(v.new, v.accurate);
+#endif
+#ifdef CHECK_TOP
+		keepTop(data, x, i, &v);
+#endif
+#ifdef CHECK_HIST
+		keepHist(data, x, i, &v, inDomain(i, x));
+#endif
+		if (s != 0) {
+			reportPoint(data, s, x, i, diff, &v);
+		}
+#else
+		if (!interesting(diff)) {
+#ifdef CHECK_HIST
+			keepHist(data, x, i, &v, 0);
+#endif
+			continue;
+		}
+		v.accurate = inDomain(i, x) ? mFricasFloatEval(data->fr, fricasFuncNames[i], x) : a[i].old;
+#ifdef CHECK_TOP
+		keepTop(data, x, i, &v);
+#endif
+#ifdef CHECK_HIST
+		keepHist(data, x, i, &v, inDomain(i, x));
+#endif
+		int s = quiteInteresting(v);
+		if (s != 0) {
+			reportPoint(data, s, x, i, diff, &v);
+		}
+#endif
+		keepPoint(data, i, &v);
+	}
+}
+
+#ifdef CHECK_NARROW
+// Check mathematical functions in the PointsInOneRange points whose
+// bit patterns are first and the ones following it.
+static
+void
+testRange(dat *data, uint16_t first) {
+	uint16_t x[PointsInOneRange], r[FuncLimit][PointsInOneRange];
+	int i;
+	for (i = 0; i < PointsInOneRange; i++) {
+		x[i] = (uint16_t)(first + i);
+	}
+	narrowBatch(x, r[sinIndex], r[cosIndex], r[omcIndex], PointsInOneRange);
+
+	data->range.limits[0] = narrowToDouble(first);
+	for (i = 0; i < PointsInOneRange; i++) {
+		sincos1cos16 sc1c = narrowScalar(x[i]);
+		if (sc1c.sin != r[sinIndex][i] || sc1c.cos != r[cosIndex][i] || sc1c.omc != r[omcIndex][i]) {
+			fprintf(stderr, "sinCosOmcTester: batch and scalar results differ for %04x\n", x[i]);
+		}
+
+		mfloat_t xx = narrowToDouble(x[i]);
+		funcVal a[FuncLimit] = {
+			{narrowToDouble(narrowFromDouble(sin(xx))), narrowToDouble(r[sinIndex][i]), 0},
+			{narrowToDouble(narrowFromDouble(cos(xx))), narrowToDouble(r[cosIndex][i]), 0},
+			{narrowToDouble(narrowFromDouble(1 - cos(xx))), narrowToDouble(r[omcIndex][i]), 0},
+		};
+		recordPoint(data, xx, a);
+	}
+	data->range.limits[1] = narrowToDouble((uint16_t)(first + PointsInOneRange));
+}
+#else
+#if defined(CHECK_EXP)
+static
+void
+checkPoint(dat *data, mfloat_t x) {
+	funcVal a[FuncLimit] = {{exp(x), 0, 0}, {expm1(x), 0, 0}};
+	expexpm1 e = exexm1(x);
+	a[expIndex].new = e.exp;
+	a[em1Index].new = e.expm1;
+	recordPoint(data, x, a);
+}
+#elif defined(CHECK_LOG)
+static
+void
+checkPoint(dat *data, mfloat_t x) {
+	funcVal a[FuncLimit] = {{log(x), 0, 0}, {log1p(x), 0, 0}};
+	loglog1p l = lglg1p(x);
+	a[logIndex].new = l.log;
+	a[l1pIndex].new = l.log1p;
+	recordPoint(data, x, a);
+}
+#elif defined(CHECK_HYP)
+static
+void
+checkPoint(dat *data, mfloat_t x) {
+	funcVal a[FuncLimit] = {{sinh(x), 0, 0}, {cosh(x), 0, 0}, {0, 0, 0}};
+	a[cm1Index].old = a[cshIndex].old - 1;
+	sinhcoshm1 h = snhcshm1(x);
+	a[snhIndex].new = h.sinh;
+	a[cshIndex].new = h.cosh;
+	a[cm1Index].new = h.coshm1;
+	recordPoint(data, x, a);
+}
+#elif defined(CHECK_PI)
+static
+void
+checkPoint(dat *data, mfloat_t x) {
+	const mfloat_t pi = 3.14159265358979323846;
+
+	funcVal a[FuncLimit] = {{sin(pi*x), 0, 0}, {cos(pi*x), 0, 0}, {0, 0, 0}};
+	a[ompIndex].old = 1 - a[cspIndex].old;
+	sincos1cos sc1c = sncs1cspi(x);
+	a[snpIndex].new = sc1c.sin;
+	a[cspIndex].new = sc1c.cos;
+	a[ompIndex].new = sc1c.omc;
+
+	mfloat_t s, c, o;
+	sncs1cspiBatch(&x, &s, &c, &o, 1);
+	if (!sameValue(s, sc1c.sin) || !sameValue(c, sc1c.cos) || !sameValue(o, sc1c.omc)) {
+		fprintf(stderr, "sinCosOmcTester: batch and scalar results differ for " FLTFMT "\n", x);
+	}
+	recordPoint(data, x, a);
+}
+#elif defined(CHECK_TAN)
+static
+void
+checkPoint(dat *data, mfloat_t x) {
+	funcVal a[FuncLimit] = {{tan(x), 0, 0}, {0, 0, 0}};
+	a[cotIndex].old = 1 / a[tanIndex].old;
+	tancot tc = tnct(x);
+	a[tanIndex].new = tc.tan;
+	a[cotIndex].new = tc.cot;
+
+	mfloat_t t, c;
+	tnctBatch(&x, &t, &c, 1);
+	if (!sameValue(t, tc.tan) || !sameValue(c, tc.cot)) {
+		fprintf(stderr, "sinCosOmcTester: batch and scalar results differ for " FLTFMT "\n", x);
+	}
+	recordPoint(data, x, a);
+}
+#elif defined(CHECK_HAV)
+static
+void
+checkPoint(dat *data, mfloat_t x) {
+	mfloat_t s = sin(x/2), h = s*s;
+	funcVal a[FuncLimit] = {{1 - cos(x), 0, 0}, {h, 0, 0}, {2*asin(sqrt(h + cos(x)*h)), 0, 0}};
+	a[vrsIndex].new = versin(x);
+	a[hvsIndex].new = haversin(x);
+
+	// From (0, 0) to (x, x).
+	const mfloat_t zero = 0;
+	hvdistBatch(&zero, &zero, &x, &x, &a[hvdIndex].new, 1);
+	if (!sameValue(a[hvdIndex].new, hvdist(0, 0, x, x))) {
+		fprintf(stderr, "sinCosOmcTester: batch and scalar results differ for " FLTFMT "\n", x);
+	}
+	recordPoint(data, x, a);
+}
+#elif defined(CHECK_CPLX)
+// Whether the two complex numbers are the same, see sameValue.
+static
+int
+sameCmplx(cmplx a, cmplx b) {
+	return sameValue(a.re, b.re) && sameValue(a.im, b.im);
+}
+
+static
+void
+checkPoint(dat *data, mfloat_t x) {
+	complex double z = CMPLX(x, x), s = csin(z), c = ccos(z), e = cexp(z);
+	funcVal a[FuncLimit] = {
+		{creal(s), 0, 0}, {cimag(s), 0, 0},
+		{creal(c), 0, 0}, {cimag(c), 0, 0},
+		{creal(e), 0, 0}, {cimag(e), 0, 0},
+	};
+	csincos sc = csncs(x, x);
+	cmplx ex = cxexp(x, x);
+	a[sreIndex].new = sc.sin.re;
+	a[simIndex].new = sc.sin.im;
+	a[creIndex].new = sc.cos.re;
+	a[cimIndex].new = sc.cos.im;
+	a[ereIndex].new = ex.re;
+	a[eimIndex].new = ex.im;
+
+	cmplx zi = {x, x}, bs, bc, be;
+	csncsBatch(&x, &x, &bs.re, &bs.im, &bc.re, &bc.im, 1);
+	cxexpBatch(&x, &x, &be.re, &be.im, 1);
+	int same = sameCmplx(bs, sc.sin) && sameCmplx(bc, sc.cos) && sameCmplx(be, ex);
+	csncsBatchI(&zi, &bs, &bc, 1);
+	cxexpBatchI(&zi, &be, 1);
+	same = same && sameCmplx(bs, sc.sin) && sameCmplx(bc, sc.cos) && sameCmplx(be, ex);
+	if (!same) {
+		fprintf(stderr, "sinCosOmcTester: batch and scalar results differ for " FLTFMT "\n", x);
+	}
+	recordPoint(data, x, a);
+}
+
+// Points off the diagonal where e^a, or cosh(b) and sinh(b), overflow,
+// but not all the parts of the results do.
+static const cmplx edges[] = {{710, 0.1}, {-710, 0.1}, {1e-300, 711}, {1e-300, -711}, {0x1p-1074, 1450}, {711, 1e-300}};
+
+// Checks csncs and cxexp at the edges, and prints the parts of their
+// results that are infinite or NaN where the accurate value is finite,
+// or the other way around.
+static
+void
+checkEdges(dat *data) {
+	size_t i;
+	int fn;
+	for (i = 0; i < sizeof(edges)/sizeof(edges[0]); i++) {
+		mfloat_t re = edges[i].re, im = edges[i].im;
+		csincos sc = csncs(re, im);
+		cmplx ex = cxexp(re, im);
+		mfloat_t new[FuncLimit] = {sc.sin.re, sc.sin.im, sc.cos.re, sc.cos.im, ex.re, ex.im};
+		for (fn = 0; fn < FuncLimit; fn++) {
+			char cmd[FricasCmdBytes];
+			sprintf(cmd, "cnf_cpart(\"%s\", " FLTFMT ", " FLTFMT ")$CNF\n", funcNames[fn], re, im);
+			mfloat_t accurate = FricasEval(data->fr, cmd);
+			if (!isfinite(new[fn]) != !isfinite(accurate)) {
+				fprintf(stderr, "sinCosOmcTester: %s is " FLTFMT " for " FLTFMT " + " FLTFMT " i, not " FLTFMT "\n",
+					funcNames[fn], new[fn], re, im, accurate);
+			}
+		}
+	}
+}
+#else
+static
+void
+checkPoint(dat *data, mfloat_t x) {
+	funcVal a[FuncLimit] = {{sin(x), 0, 0}, {cos(x), 0, 0}, {0, 0, 0}};
+	a[omcIndex].old = 1 - a[cosIndex].old;
+	msincos1cos sc1c = msncs1cs(x);
+	a[sinIndex].new = sc1c.sin;
+	a[cosIndex].new = sc1c.cos;
+	a[omcIndex].new = sc1c.omc;
+	recordPoint(data, x, a);
+}
+#endif
+
+#ifndef CHECK_SAMPLE
+// Check mathematical functions in PointsInOneRange points after and
+// including x.
+static
+void
+testRange(dat *data, mfloat_t x) {
+	data->range.limits[0] = x;
+	int i;
+	for (i = 0; i < PointsInOneRange; i++) {
+		checkPoint(data, x);
+		x = nextafter(x, posInf);
+	}
+	data->range.limits[1] = x;
+}
+#else
+static
+int
+compareValues(const void *a, const void *b) {
+	mfloat_t x = *(const mfloat_t *)a, y = *(const mfloat_t *)b;
+	return (y < x) - (x < y);
+}
+
+// Draws the samples of stratum s, uniformly over its bit patterns,
+// without repetition, and sorts them, so that the points of the report
+// are in the order of x, as in the other sweeps. A binade with no more
+// values than SamplePoints is taken whole.
+static
+void
+drawSamples(dat *data, int s) {
+	int w, i, n = SamplePoints;
+	uint64 base = binadeBits(s, &w);
+	if ((1UL << w) <= (uint64)n) {
+		n = 1 << w;
+		for (i = 0; i < n; i++) {
+			data->samples[i] = sampleValue(s, base + (uint64)(s < SampleBinades ? n - 1 - i : i));
+		}
+		data->nsamples = n;
+		return;
+	}
+	for (i = 0; i < n; i++) {
+		data->samples[i] = sampleValue(s, base + (nextRandom(data) >> (64 - w)));
+	}
+	for (;;) {
+		// Repeated values are drawn again.
+		int again = 0 != 0;
+		qsort(data->samples, (size_t)n, sizeof(data->samples[0]), compareValues);
+		for (i = 1; i < n; i++) {
+			if (data->samples[i] == data->samples[i - 1]) {
+				data->samples[i] = sampleValue(s, base + (nextRandom(data) >> (64 - w)));
+				again = 0 == 0;
+			}
+		}
+		if (!again) {
+			break;
+		}
+	}
+	data->nsamples = n;
+}
+
+// Checks the mathematical functions in the points of the current range
+// of samples, range data->i % SampleRanges of stratum data->i /
+// SampleRanges.
+static
+void
+sampleRange(dat *data) {
+	int s = data->i / SampleRanges, first = data->i % SampleRanges * PointsInOneRange, i;
+	if (first == 0) {
+		drawSamples(data, s);
+	}
+	int last = first + PointsInOneRange < data->nsamples ? first + PointsInOneRange : data->nsamples;
+	if (last <= first) {
+		int w;
+		data->range.limits[0] = data->range.limits[1] = sampleValue(s, binadeBits(s, &w));
+		return;
+	}
+	data->range.limits[0] = data->samples[first];
+	for (i = first; i < last; i++) {
+		checkPoint(data, data->samples[i]);
+	}
+	data->range.limits[1] = nextafter(data->samples[last - 1], posInf);
+	data->sampled += last - first;
+}
+#endif
+#endif
+
+static
+void
+updateMicroReport(microReport *r, int64 iS, mfloat_t fS) {
+	r->count++;
+	r->mean2 += fS * fS;
+	if (0 <= iS && r->max < iS || iS <= 0 && iS <= r->max) {
+		r->max = iS;
+	}
+	if (copysign(r->maxScor, (mfloat_t)1) < copysign(fS, (mfloat_t)1)) {
+		r->maxScor = fS;
+	}
+}
+
+// Adds the scores of a point to r.
+static
+void
+updateRangeReport(rangeReport *r, ifscor s) {
+	if (0 < s.iscor) {
+		updateMicroReport(&r->improvements, s.iscor, s.fscor);
+	} else {
+		updateMicroReport(&r->worsenings, s.iscor, s.fscor);
+	}
+	r->mean1 += s.fscor;
+}
+
+// Turns the sums of r into means, after its last point.
+static
+void
+finishRangeReport(rangeReport *r) {
+	r->improvements.mean2 = sqrt(r->improvements.mean2 / (mfloat_t)r->improvements.count);
+	r->worsenings.mean2 = sqrt(r->worsenings.mean2 / (mfloat_t)r->worsenings.count);
+	r->mean1 /= (mfloat_t)(r->improvements.count + r->worsenings.count);
+}
+
+// Adds the current range to the reports of each function, and to the
+// nodes of its pyramids, then drops its points. All the functions are
+// done in one pass, as each range is done, so the sums of each report
+// are taken in the order of the ranges and of their points.
+static
+void
+aggregateRange(dat *data) {
+	Range *r = &data->range;
+	int fn;
+#ifdef CHECK_PYRAMID
+	int l, e;
+#endif
+	for (fn = 0; fn < FuncLimit; fn++) {
+		rangeSlice *d = &data->byFunction[fn];
+		int exists = 0 != 0, point;
+		int64 iscor[PointsInOneRange], bc[PointsInOneRange];
+		int n = scoreRange(r, fn, iscor, bc);
+		for (point = 0; point < n; point++) {
+			// Skip points without a relevant change; those with
+			// equal old and new values score 0 too.
+			if (iscor[point] == 0) {
+				continue;
+			}
+			ifscor s = {iscor[point], (mfloat_t)iscor[point] / (mfloat_t)bc[point]};
+
+			if (!exists) {
+				// Doubles, in place when nothing was allocated
+				// after it; the new elements are zero.
+				if (d->i == d->cap) {
+					int cap = d->cap == 0 ? 64 : 2*d->cap;
+					d->p = grow(data, d->p, (size_t)d->cap*sizeof(rangeReport), (size_t)cap*sizeof(rangeReport));
+					d->cap = cap;
+				}
+				d->i++;
+			}
+			exists = 0 == 0;
+			updateRangeReport(&d->p[d->i-1], s);
+#ifdef CHECK_PYRAMID
+			for (l = 0; l < ResPyramidLevels; l++) {
+				updateRangeReport(&data->pyramid[fn][l][data->i/data->span[l]], s);
+			}
+#endif
+		}
+		if (exists) {
+			d->p[d->i-1].limits[0] = r->limits[0];
+			d->p[d->i-1].limits[1] = r->limits[1];
+			finishRangeReport(&d->p[d->i-1]);
+		}
+#ifdef CHECK_PYRAMID
+		// The least and the greatest limit of all the ranges of
+		// each node, whether they have changes or not.
+		for (l = 0; l < ResPyramidLevels; l++) {
+			rangeReport *p = &data->pyramid[fn][l][data->i/data->span[l]];
+			if (data->i % data->span[l] == 0) {
+				p->limits[0] = p->limits[1] = r->limits[0];
+			}
+			for (e = 0; e < 2; e++) {
+				if (r->limits[e] < p->limits[0]) {
+					p->limits[0] = r->limits[e];
+				}
+				if (p->limits[1] < r->limits[e]) {
+					p->limits[1] = r->limits[e];
+				}
+			}
+		}
+#endif
+		r->points[fn].n = 0;
+	}
+}
+
+// Reports r, as a range, or with tag ResPyramid, as a node of the level.
+static
+void
+reportRange(dat *data, int tag, int fn, int level, const rangeReport *p) {
+	ResRecord r = {tag, fn, level};
+	r.count[0] = p->improvements.count;
+	r.count[1] = p->worsenings.count;
+	r.max[0] = p->improvements.max;
+	r.max[1] = p->worsenings.max;
+	resSetValue(&data->h, r.v[ResLimit0], &p->limits[0]);
+	resSetValue(&data->h, r.v[ResLimit1], &p->limits[1]);
+	resSetValue(&data->h, r.v[ResImprovMaxScor], &p->improvements.maxScor);
+	resSetValue(&data->h, r.v[ResImprovMean2], &p->improvements.mean2);
+	resSetValue(&data->h, r.v[ResWorseMaxScor], &p->worsenings.maxScor);
+	resSetValue(&data->h, r.v[ResWorseMean2], &p->worsenings.mean2);
+	resSetValue(&data->h, r.v[ResMean1], &p->mean1);
+	report(data, &r);
+}
+
+#ifdef CHECK_SAMPLE
+// Sets r to the Wilson score interval, at 95% confidence, of the rate
+// of k points in a sample of n; to the rate itself, without bounds,
+// when the sample is all of its binade.
+static
+void
+rateInterval(int64 k, int64 n, int whole, mfloat_t r[3]) {
+	const mfloat_t z = 1.95996398454005423552;
+	mfloat_t p = (mfloat_t)k / (mfloat_t)n, m = (mfloat_t)n;
+	r[0] = r[1] = r[2] = p;
+	if (whole) {
+		return;
+	}
+	mfloat_t d = 1 + z*z/m, c = (p + z*z/(2*m))/d, h = z*sqrt(p*(1 - p)/m + z*z/(4*m*m))/d;
+	r[1] = k == 0 ? 0 : fmax(c - h, 0);
+	r[2] = k == n ? 1 : fmin(c + h, 1);
+}
+
+// Reports the tallies of the points of the function in each octant of
+// each binade, with the estimated rates of the misrounded old and new
+// values, then the estimates for the whole domain: the rate of each
+// binade weighted by its share of the finite nonzero values, with
+// normal confidence bounds from the variance of the stratified
+// estimate.
+static
+void
+reportSamples(dat *data, int fn) {
+	mfloat_t all = 0, est[2] = {0, 0}, var[2] = {0, 0};
+	int64 total = 0, wrong[2] = {0, 0};
+	int s, o, j, w;
+	for (s = 0; s < SampleStrata; s++) {
+		binadeBits(s, &w);
+		all += ldexp((mfloat_t)1, w);
+	}
+	for (s = 0; s < SampleStrata; s++) {
+		uint64 base = binadeBits(s, &w);
+		mfloat_t low = sampleValue(s, base), size = ldexp((mfloat_t)1, w);
+		int whole = (1UL << w) <= (uint64)SamplePoints;
+		int64 n = 0, k[2] = {0, 0};
+		for (o = 0; o < SampleOctants; o++) {
+			const sampleCell *c = &data->cells[(fn*SampleStrata + s)*SampleOctants + o];
+			if (c->total == 0) {
+				continue;
+			}
+			ResRecord r = {ResSample, fn, o};
+			r.total = c->total;
+			resSetValue(&data->h, r.v[ResBinade], &low);
+			for (j = 0; j < 2; j++) {
+				mfloat_t b[3];
+				r.counts[j] = c->wrong[j];
+				rateInterval(c->wrong[j], c->total, whole, b);
+				resSetValue(&data->h, r.v[ResOldRate + 3*j], &b[0]);
+				resSetValue(&data->h, r.v[ResOldLow + 3*j], &b[1]);
+				resSetValue(&data->h, r.v[ResOldHigh + 3*j], &b[2]);
+				k[j] += c->wrong[j];
+			}
+			n += c->total;
+			report(data, &r);
+		}
+		if (n == 0) {
+			continue;
+		}
+		mfloat_t weight = size/all, m = (mfloat_t)n;
+		for (j = 0; j < 2; j++) {
+			mfloat_t p = (mfloat_t)k[j]/m;
+			est[j] += weight*p;
+			var[j] += weight*weight*p*(1 - p)/m*(1 - m/size);
+			wrong[j] += k[j];
+		}
+		total += n;
+	}
+
+	ResRecord r = {ResSample, fn, ResSampleOctants};
+	const mfloat_t z = 1.95996398454005423552, zero = 0;
+	r.total = total;
+	resSetValue(&data->h, r.v[ResBinade], &zero);
+	for (j = 0; j < 2; j++) {
+		mfloat_t b[3] = {est[j], fmax(est[j] - z*sqrt(var[j]), 0), fmin(est[j] + z*sqrt(var[j]), 1)};
+		r.counts[j] = wrong[j];
+		resSetValue(&data->h, r.v[ResOldRate + 3*j], &b[0]);
+		resSetValue(&data->h, r.v[ResOldLow + 3*j], &b[1]);
+		resSetValue(&data->h, r.v[ResOldHigh + 3*j], &b[2]);
+	}
+	report(data, &r);
+}
+#endif
+
+int
+main(void) {
+#if defined(CHECK_SAMPLE)
+	// SampleRanges ranges of samples of each binade.
+	const int size = SampleStrata*SampleRanges;
+#elif defined(CHECK_NARROW)
+	// All bit patterns.
+	const int size = 65536 / PointsInOneRange;
+#elif defined(CHECK_WIDE)
+	// Check for regressions.
 	const mfloat_t start = -12.5663706143591729539, step = 0.03125;
 	const int size = 2*(int)((-start + 0.5)/step + 0.5) + 1;
 #else
 	// Check improvements.
 	const mfloat_t start = 0, step = 1.52587890625e-05;
-	const int size = 500;
+	int size = 500;
 #endif
+#if defined(CHECK_TAN) && !defined(CHECK_WIDE) && !defined(CHECK_SAMPLE)
+	// 16 ULPs below the double nearest to pi/2, so that one range
+	// straddles the pole.
+	const mfloat_t pole = 1.57079632679489661923 - 0x1p-48;
 
-	dat data = {FricasFloatNew(), calloc(size, sizeof(Range)), 0};
+	// The tiny x, where cot overflows, in ranges before the others, in
+	// order: the negative subnormals next to -0 and -0 itself, the
+	// first range of the others, from +0, and the ranges around the
+	// least normal value and around 2^-997, below which 1/tan(x) is too
+	// large to be corrected like the others.
+	static const mfloat_t tiny[] = {-0x1fp-1074, 0, 0x1p-1022 - 0x10p-1074, 0x1p-997 - 0x10p-1050};
+	const int ntiny = sizeof(tiny)/sizeof(tiny[0]) - 1;
+	size += ntiny;
+#endif
+
+	dat data = {FricasFloatNewDigits(FricasDigits)};
 	if (data.fr.in == nil || data.fr.out == nil) {
 		fprintf(stderr, "sinCosOmcTester: failed to use fricas\n");
 		return 1;
 	}
+	if ((data.arena = resArenaOpen(ArenaHuge)) == nil) {
+		fprintf(stderr, "sinCosOmcTester: out of memory\n");
+		return 1;
+	}
+	resInitHeader(&data.h, ValueKind, FuncLimit, PointsInOneRange, funcNames);
+#ifdef CHECK_TOP
+	data.top = alloc(&data, FuncLimit*ResTopLists*sizeof(data.top[0]));
+#endif
+#ifdef CHECK_HIST
+	data.hist = alloc(&data, FuncLimit*2*HistBinades*sizeof(data.hist[0]));
+#endif
+#ifdef CHECK_SAMPLE
+	data.cells = alloc(&data, (size_t)FuncLimit*SampleStrata*SampleOctants*sizeof(data.cells[0]));
+	seedSamples(&data, (uint64)(CHECK_SAMPLE));
+#endif
+	resTextInit(&data.text, &data.h);
+#if defined(CHECK_BINARY)
+	setvbuf(stdout, nil, _IOFBF, ResBufferBytes);
+	if (resWriteHeader(stdout, &data.h)) {
+		fprintf(stderr, "sinCosOmcTester: failed to write the report\n");
+		return 1;
+	}
+#elif defined(CHECK_STORE)
+	resStoreWriterInit(&data.store, &data.h);
+#elif defined(CHECK_COMPRESS)
+	if ((data.z = resZWriterOpen(stdout, &data.h)) == nil) {
+		fprintf(stderr, "sinCosOmcTester: failed to write the report\n");
+		return 1;
+	}
+#endif
+	if ((data.log = resLogOpen(&data.h, sink, &data)) == nil) {
+		fprintf(stderr, "sinCosOmcTester: failed to start the report writer\n");
+		return 1;
+	}
+	int fn;
+#ifdef CHECK_PYRAMID
+	int l;
+	for (l = 0; l < ResPyramidLevels; l++) {
+		data.span[l] = l == 0 ? ResPyramidFactor : data.span[l - 1]*ResPyramidFactor;
+		data.nodes[l] = (size + data.span[l] - 1)/data.span[l];
+		for (fn = 0; fn < FuncLimit; fn++) {
+			data.pyramid[fn][l] = alloc(&data, (size_t)data.nodes[l]*sizeof(rangeReport));
+		}
+	}
+#endif
 	for (; data.i < size; data.i++) {
+#if defined(CHECK_SAMPLE)
+		sampleRange(&data);
+#elif defined(CHECK_NARROW)
+		testRange(&data, (uint16_t)(data.i * PointsInOneRange));
+#elif defined(CHECK_TAN) && !defined(CHECK_WIDE)
+		if (data.i <= ntiny) {
+			testRange(&data, tiny[data.i]);
+		} else if (data.i - ntiny < (size - ntiny)/2) {
+			testRange(&data, start + step*(mfloat_t)(data.i - ntiny));
+		} else {
+			testRange(&data, pole + step*(mfloat_t)(data.i - ntiny - 3*(size - ntiny)/4));
+		}
+#else
 		testRange(&data, start + step*(mfloat_t)data.i);
+#endif
+		aggregateRange(&data);
 	}
+#ifdef CHECK_CPLX
+	checkEdges(&data);
+#endif
 	if (FricasClose(data.fr)) {
 		fprintf(stderr, "sinCosOmcTester: failed to close fricas pipes\n");
 	}
 
-	typedef struct {
-		rangeReport *p;
-		int i;
-	} slice;
+	// Report each range of each function where interesting
+	// differences were recorded.
+	for (fn = 0; fn < FuncLimit; fn++) {
+		int ran;
+		for (ran = 0; ran < data.byFunction[fn].i; ran++) {
+			reportRange(&data, ResRange, fn, 0, &data.byFunction[fn].p[ran]);
+		}
+	}
 
-	// Array with an element for each mathematical function, each containing
-	// a slice with a rangeReport for each range.
-	slice dataByFunction[FuncLimit];
-	int fn, ran;
+#ifdef CHECK_VERIFY
+	for (fn = 0; fn < FuncLimit; fn++) {
+		ResRecord r = {ResMisrounded, fn};
+		r.misrounded = data.misrounded[fn];
+#ifdef CHECK_SAMPLE
+		r.total = data.sampled;
+#else
+		r.total = size * PointsInOneRange;
+#endif
+		report(&data, &r);
+	}
+#endif
+#ifdef CHECK_TOP
 	for (fn = 0; fn < FuncLimit; fn++) {
-		for (dataByFunction[fn].i = 0, ran = 0; ran < data.i; ran++) {
-			int exists = 0 != 0, point;
-			for (point = 0; point < PointsInOneRange; point++) {
-				// Skip points without a change.
-				if (isNull(data.funcData[ran].a[point][fn])) {
+		int l, j;
+		for (l = 0; l < ResTopLists; l++) {
+			ResTopHeap *t = &data.top[fn*ResTopLists + l];
+			resTopSort(t);
+			for (j = 0; j < t->n; j++) {
+				report(&data, &t->e[j].r);
+			}
+		}
+	}
+#endif
+#ifdef CHECK_HIST
+	for (fn = 0; fn < FuncLimit; fn++) {
+		int s, j;
+		for (s = ResHistOld; s <= ResHistNew; s++) {
+			for (j = 0; j < 2*HistBinades; j++) {
+				const binadeHist *b = data.hist[fn*2*HistBinades + j];
+				if (b == nil) {
 					continue;
 				}
-
-				ifscor s = scoresOf(data.funcData[ran].a[point][fn]);
-				// Skip points without a relevant change.
-				if (s.iscor == 0) {
+				ResRecord r = {ResHist, fn, s};
+				r.total = b->total;
+				resSetValue(&data.h, r.v[0], &b->low);
+				memcpy(r.counts, b->counts[s], sizeof(r.counts));
+				report(&data, &r);
+			}
+		}
+	}
+#endif
+#ifdef CHECK_PYRAMID
+	// The nodes with changes.
+	for (fn = 0; fn < FuncLimit; fn++) {
+		for (l = 0; l < ResPyramidLevels; l++) {
+			int j;
+			for (j = 0; j < data.nodes[l]; j++) {
+				rangeReport *p = &data.pyramid[fn][l][j];
+				if (p->improvements.count + p->worsenings.count == 0) {
 					continue;
 				}
-
-				if (!exists) {
-					dataByFunction[fn].i++;
-					if (dataByFunction[fn].i == 1) {
-						dataByFunction[fn].p = calloc(1, sizeof(rangeReport));
-					} else {
-						dataByFunction[fn].p = realloc(dataByFunction[fn].p,
-								sizeof(rangeReport) * dataByFunction[fn].i);
-						memset(&dataByFunction[fn].p[dataByFunction[fn].i-1], 0, sizeof(rangeReport));
-					}
-				}
-				exists = 0 == 0;
-				if (0 < s.iscor) {
-					updateMicroReport(&dataByFunction[fn].p[dataByFunction[fn].i-1].improvements, s.iscor, s.fscor);
-				} else  {
-					updateMicroReport(&dataByFunction[fn].p[dataByFunction[fn].i-1].worsenings, s.iscor, s.fscor);
-				}
-				dataByFunction[fn].p[dataByFunction[fn].i-1].mean1 += s.fscor;
-			}
-			if(exists) {
-				dataByFunction[fn].p[dataByFunction[fn].i-1].limits[0] = data.funcData[ran].limits[0];
-				dataByFunction[fn].p[dataByFunction[fn].i-1].limits[1] = data.funcData[ran].limits[1];
-				dataByFunction[fn].p[dataByFunction[fn].i-1].improvements.mean2 =
-					sqrt(dataByFunction[fn].p[dataByFunction[fn].i-1].improvements.mean2 /
-						(mfloat_t)dataByFunction[fn].p[dataByFunction[fn].i-1].improvements.count);
-				dataByFunction[fn].p[dataByFunction[fn].i-1].worsenings.mean2 =
-					sqrt(dataByFunction[fn].p[dataByFunction[fn].i-1].worsenings.mean2 /
-						(mfloat_t)dataByFunction[fn].p[dataByFunction[fn].i-1].worsenings.count);
-				dataByFunction[fn].p[dataByFunction[fn].i-1].mean1 /= (mfloat_t)(
-					dataByFunction[fn].p[dataByFunction[fn].i-1].improvements.count +
-					dataByFunction[fn].p[dataByFunction[fn].i-1].worsenings.count);
+				finishRangeReport(p);
+				reportRange(&data, ResPyramid, fn, l + 1, p);
 			}
 		}
 	}
-
-	// Print reports for each range of each function where interesting
-	// differences were recorded, from dataByFunction.
-	printf("\n\nPointsInOneRange: %5d\n\n\n", PointsInOneRange);
+#endif
+#ifdef CHECK_SAMPLE
 	for (fn = 0; fn < FuncLimit; fn++) {
-		printf("%3s:\n", funcNames[fn]);
-		for (ran = 0; ran < dataByFunction[fn].i; ran++) {
-#define fMR "%7d %22ld " FLTFMT " " FLTFMT "\n"
-			printf(FLTFMT " " FLTFMT "\n" fMR fMR FLTFMT "\n\n",
-				dataByFunction[fn].p[ran].limits[0], dataByFunction[fn].p[ran].limits[1],
-				dataByFunction[fn].p[ran].improvements.count, dataByFunction[fn].p[ran].improvements.max, dataByFunction[fn].p[ran].improvements.maxScor, dataByFunction[fn].p[ran].improvements.mean2,
-				dataByFunction[fn].p[ran].worsenings.count, dataByFunction[fn].p[ran].worsenings.max, dataByFunction[fn].p[ran].worsenings.maxScor, dataByFunction[fn].p[ran].worsenings.mean2,
-				dataByFunction[fn].p[ran].mean1);
-		}
-		printf("\n\n");
+		reportSamples(&data, fn);
 	}
+#endif
+	if (resLogClose(data.log)) {
+		fprintf(stderr, "sinCosOmcTester: failed to write the report\n");
+		return 1;
+	}
+#if defined(CHECK_STORE)
+	setvbuf(stdout, nil, _IOFBF, ResBufferBytes);
+	if (resStoreFinish(&data.store, stdout)) {
+		fprintf(stderr, "sinCosOmcTester: failed to write the store\n");
+		return 1;
+	}
+#elif defined(CHECK_COMPRESS)
+	if (resZWriterClose(data.z)) {
+		fprintf(stderr, "sinCosOmcTester: failed to write the report\n");
+		return 1;
+	}
+#elif !defined(CHECK_BINARY)
+	resTextEnd(&data.text, stdout);
+#endif
+	if (fflush(stdout)) {
+		fprintf(stderr, "sinCosOmcTester: failed to write the report\n");
+		return 1;
+	}
+
+	ResArenaStats st;
+	resArenaStats(data.arena, &st);
+	fprintf(stderr, "sinCosOmcTester: %lu allocations of %lu bytes (%lu grown in place, %lu bytes copied) in %lu chunks of %lu bytes, %lu with huge pages\n",
+		(unsigned long)st.allocs, (unsigned long)st.bytes, (unsigned long)st.grownInPlace, (unsigned long)st.copiedBytes,
+		(unsigned long)st.chunks, (unsigned long)st.mappedBytes, (unsigned long)st.hugeChunks);
+	resArenaClose(data.arena);
+	return 0;
 }
@@ -0,0 +1,165 @@
+/* Complex sine and cosine together, and complex exp:
+ *
+ *	sin(a + bi) = sin(a) cosh(b) + i cos(a) sinh(b),
+ *	cos(a + bi) = cos(a) cosh(b) - i sin(a) sinh(b),
+ *	exp(a + bi) = e^a cos(b) + i e^a sin(b),
+ *
+ * with the trigonometric functions from sncs1cs, and the hyperbolic ones
+ * from snhcshm1, so that there are two reductions per complex number,
+ * instead of four when calling csin and ccos. The batch versions take
+ * and give either separate arrays of the real and of the imaginary
+ * parts, or arrays of interleaved ones (cmplx, which has the layout of
+ * double _Complex).
+ *
+ * A zero factor gives a zero even if the other factor overflowed, so
+ * that, e.g., sin(0 + 800i) = 0 + inf i. Where e^a, or cosh(b) and
+ * sinh(b), overflow, the products are scaled, so that those that fit
+ * in a double are finite, e.g. exp(710 + 0.1i). Otherwise the special
+ * cases of C's Annex G are not followed.
+ */
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "kernels.h"
+
+enum {
+	/* Elements handled in one go by the batch functions. */
+	BatchLanes = 64,
+};
+
+/* x*y, but a zero (with the sign of the product) for a zero x. */
+static inline
+double
+mulz(double x, double y) {
+	return x == 0 ? x * copysign(1, y) : x * y;
+}
+
+/* Beyond this, e^|x| overflows, or nearly, and is taken as q^4 with
+ * q = e^(|x|/4), which is exact but for the rounding of q. */
+static const double expScaleth = 709;
+
+/* x*q^4*s, for s of 1 or 1/2, multiplied in an order where nothing
+ * overflows unless the result does, nor underflows for q >= e^177, and
+ * a zero for a zero x, like mulz. */
+static inline
+double
+mulPow4(double x, double q, double s) {
+	return x == 0 ? x : (((x * q) * q) * q) * (s * q);
+}
+
+static inline
+csincos
+fromParts(double sin, double cos, double im) {
+	csincos r;
+	if (fabs(im) < expScaleth) {
+		sinhcoshm1 h = snhcshm1(im);
+		r.sin.re = mulz(sin, h.cosh);
+		r.sin.im = mulz(cos, h.sinh);
+		r.cos.re = mulz(cos, h.cosh);
+		r.cos.im = -mulz(sin, h.sinh);
+		return r;
+	}
+	/* cosh(b) = e^|b|/2 and sinh(b) = sign(b) e^|b|/2 */
+	double q = exexm1(0.25 * fabs(im)).exp, s = copysign(1, im);
+	r.sin.re = mulPow4(sin, q, 0.5);
+	r.sin.im = s * mulPow4(cos, q, 0.5);
+	r.cos.re = mulPow4(cos, q, 0.5);
+	r.cos.im = -s * mulPow4(sin, q, 0.5);
+	return r;
+}
+
+static inline
+cmplx
+expFromParts(double re, double sin, double cos) {
+	cmplx r;
+	if (re < expScaleth) {
+		double e = exexm1(re).exp;
+		r.re = mulz(cos, e);
+		r.im = mulz(sin, e);
+		return r;
+	}
+	double q = exexm1(0.25 * re).exp;
+	r.re = mulPow4(cos, q, 1);
+	r.im = mulPow4(sin, q, 1);
+	return r;
+}
+
+csincos
+csncs(double re, double im) {
+	sincos1cos t = sncs1cs(re);
+	return fromParts(t.sin, t.cos, im);
+}
+
+cmplx
+cxexp(double re, double im) {
+	sincos1cos t = sncs1cs(im);
+	return expFromParts(re, t.sin, t.cos);
+}
+
+void
+csncsBatch(const double *re, const double *im, double *sinRe, double *sinIm, double *cosRe, double *cosIm, size_t n) {
+	double sin[BatchLanes], cos[BatchLanes], omc[BatchLanes];
+	size_t i, k, m;
+	for (i = 0; i < n; i += m) {
+		m = n - i < BatchLanes ? n - i : BatchLanes;
+		sncs1csBatch(&re[i], sin, cos, omc, m);
+		for (k = 0; k < m; k++) {
+			csincos r = fromParts(sin[k], cos[k], im[i + k]);
+			sinRe[i + k] = r.sin.re;
+			sinIm[i + k] = r.sin.im;
+			cosRe[i + k] = r.cos.re;
+			cosIm[i + k] = r.cos.im;
+		}
+	}
+}
+
+void
+csncsBatchI(const cmplx *z, cmplx *sinz, cmplx *cosz, size_t n) {
+	double re[BatchLanes], sin[BatchLanes], cos[BatchLanes], omc[BatchLanes];
+	size_t i, k, m;
+	for (i = 0; i < n; i += m) {
+		m = n - i < BatchLanes ? n - i : BatchLanes;
+		for (k = 0; k < m; k++) {
+			re[k] = z[i + k].re;
+		}
+		sncs1csBatch(re, sin, cos, omc, m);
+		for (k = 0; k < m; k++) {
+			csincos r = fromParts(sin[k], cos[k], z[i + k].im);
+			sinz[i + k] = r.sin;
+			cosz[i + k] = r.cos;
+		}
+	}
+}
+
+void
+cxexpBatch(const double *re, const double *im, double *expRe, double *expIm, size_t n) {
+	double sin[BatchLanes], cos[BatchLanes], omc[BatchLanes];
+	size_t i, k, m;
+	for (i = 0; i < n; i += m) {
+		m = n - i < BatchLanes ? n - i : BatchLanes;
+		sncs1csBatch(&im[i], sin, cos, omc, m);
+		for (k = 0; k < m; k++) {
+			cmplx r = expFromParts(re[i + k], sin[k], cos[k]);
+			expRe[i + k] = r.re;
+			expIm[i + k] = r.im;
+		}
+	}
+}
+
+void
+cxexpBatchI(const cmplx *z, cmplx *expz, size_t n) {
+	double im[BatchLanes], sin[BatchLanes], cos[BatchLanes], omc[BatchLanes];
+	size_t i, k, m;
+	for (i = 0; i < n; i += m) {
+		m = n - i < BatchLanes ? n - i : BatchLanes;
+		for (k = 0; k < m; k++) {
+			im[k] = z[i + k].im;
+		}
+		sncs1csBatch(im, sin, cos, omc, m);
+		for (k = 0; k < m; k++) {
+			expz[i + k] = expFromParts(z[i + k].re, sin[k], cos[k]);
+		}
+	}
+}
@@ -0,0 +1,110 @@
+/* exexm1 gives both exp(x) and expm1(x), from one argument reduction,
+ * like sncs1cs gives the sine, cosine and 1-cosine. With x = k ln 2 +
+ * z, |z| <= ln 2/2, expm1(z) = z + z^2/2 + z^3 P(z) is evaluated
+ * without cancellation, and then
+ *
+ *	exp(x) = 2^k (1 + expm1(z)),
+ *	expm1(x) = (2^k - 1) + 2^k expm1(z),
+ *
+ * where 2^k - 1 is exact for the k for which it matters. The reduction
+ * constants and the thresholds are from the Cephes Math Library's
+ * exp.c, Copyright © 1984, 1995, 2000 Stephen L. Moshier. P is a
+ * minimax fit in relative error, like the ones remez/ makes.
+ */
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "kernels.h"
+
+static const double P[] = {
+	2.08939725595681469071E-9,
+	2.51003579586090713710E-8,
+	2.75573296089868035663E-7,
+	2.75572685232271067283E-6,
+	2.48015872751492587479E-5,
+	1.98412698630083528542E-4,
+	1.38888888889005553550E-3,
+	8.33333333333007217526E-3,
+	4.16666666666666546250E-2,
+	1.66666666666666674490E-1,
+};
+
+static const double C1 = 6.93145751953125E-1;
+static const double C2 = 1.42860682030941723212E-6;
+
+static const double LOG2E = 1.4426950408889634073599;
+
+/* exp overflows above MAXLOG and underflows to zero below MINLOG. */
+static const double MAXLOG = 7.09782712893383996843E2;
+static const double MINLOG = -7.45133219101941108420E2;
+
+/* Returns a + b, rounded, and sets *e to the rounding error. */
+static
+double
+twoSum(double a, double b, double *e) {
+	double s = a + b, bb = s - a;
+	*e = (a - (s - bb)) + (b - bb);
+	return s;
+}
+
+expexpm1
+exexm1(double x) {
+	expexpm1 r;
+
+	/* Handle +-0. */
+	if (x == 0) {
+		r.exp = 1;
+		r.expm1 = x;
+		return r;
+	}
+	if (isnan(x)) {
+		r.exp = r.expm1 = x;
+		return r;
+	}
+	if (x > MAXLOG) {
+		r.exp = r.expm1 = HUGE_VAL;
+		return r;
+	}
+	if (x < MINLOG) {
+		r.exp = 0;
+		r.expm1 = -1;
+		return r;
+	}
+
+	double y = floor(LOG2E * x + 0.5);
+	int k = (int)y;
+	/* x - y*C1 is exact, so z + zLo is the reduced argument to about
+	 * twice the precision. */
+	double a = x - y * C1, b = y * C2;
+	double z = a - b, zLo = (a - z) - b;
+	double zz = z * z;
+	double p = P[0];
+	int i;
+	for (i = 1; i < (int)(sizeof(P) / sizeof(P[0])); i++) {
+		p = p*z + P[i];
+	}
+	double t = 0.5*zz + zz*z*p;
+	/* expm1(z + zLo) = em1 + em1Lo, where em1Lo has the rounding
+	 * error and zLo times the derivative, exp(z) ~ 1 + z. */
+	double em1 = z + t, em1Lo = (t - (em1 - z)) + zLo*(1 + z);
+
+	/* The sums keep their rounding errors, so that both results are
+	 * within an ULP, even where 2^k - 1 and 2^k expm1(z) partly
+	 * cancel. */
+	double e, s = twoSum(1, em1, &e);
+	r.exp = ldexp(s + (e + em1Lo), k);
+	if (k == 0) {
+		r.expm1 = em1;
+	} else if (-53 <= k && k <= 53) {
+		s = twoSum(ldexp(1, k) - 1, ldexp(em1, k), &e);
+		r.expm1 = s + (e + ldexp(em1Lo, k));
+	} else if (k > 53) {
+		/* The -1 is a small correction to the exp sum. */
+		r.expm1 = ldexp(s + ((e + em1Lo) - ldexp(1, -k)), k);
+	} else {
+		r.expm1 = r.exp - 1;
+	}
+	return r;
+}
@@ -0,0 +1,71 @@
+/* Versine and haversine, and the great-circle distance on the unit
+ * sphere (the central angle) between points given by their latitudes
+ * and longitudes in radians, with the haversine formula:
+ *
+ *	hav(d) = hav(lat2 - lat1) + cos(lat1) cos(lat2) hav(lon2 - lon1),
+ *	d = 2 asin(sqrt(hav(d))).
+ *
+ * hav(x) = (1 - cos(x))/2 is just the omc of sncs1cs halved, so it is
+ * accurate for small x, like the usual sin(x/2)^2, but all four
+ * functions of a pair of points come from sncs1cs. The batch version
+ * takes each coordinate in a separate array, so that it can work on
+ * blocks of them with sncs1csBatch, which vectorizes.
+ */
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "kernels.h"
+
+enum {
+	/* Pairs of points handled in one go by hvdistBatch. */
+	BatchLanes = 64,
+};
+
+double
+versin(double x) {
+	return sncs1cs(x).omc;
+}
+
+double
+haversin(double x) {
+	return 0.5 * sncs1cs(x).omc;
+}
+
+/* The central angle from the versines of the differences of the
+ * latitudes and of the longitudes, and the cosines of the latitudes.
+ * Rounding can take hav(d) slightly above one for antipodal points. */
+static inline
+double
+angle(double vlat, double cos1, double cos2, double vlon) {
+	double h = 0.5 * (vlat + cos1*cos2*vlon);
+	return 2 * asin(sqrt(fmin(h, 1)));
+}
+
+double
+hvdist(double lat1, double lon1, double lat2, double lon2) {
+	return angle(sncs1cs(lat2 - lat1).omc, sncs1cs(lat1).cos, sncs1cs(lat2).cos, sncs1cs(lon2 - lon1).omc);
+}
+
+void
+hvdistBatch(const double *lat1, const double *lon1, const double *lat2, const double *lon2, double *d, size_t n) {
+	double dlat[BatchLanes], dlon[BatchLanes];
+	double vlat[BatchLanes], vlon[BatchLanes], cos1[BatchLanes], cos2[BatchLanes];
+	double sin[BatchLanes], cos[BatchLanes], omc[BatchLanes];
+	size_t i, k, m;
+	for (i = 0; i < n; i += m) {
+		m = n - i < BatchLanes ? n - i : BatchLanes;
+		for (k = 0; k < m; k++) {
+			dlat[k] = lat2[i + k] - lat1[i + k];
+			dlon[k] = lon2[i + k] - lon1[i + k];
+		}
+		sncs1csBatch(dlat, sin, cos, vlat, m);
+		sncs1csBatch(dlon, sin, cos, vlon, m);
+		sncs1csBatch(&lat1[i], sin, cos1, omc, m);
+		sncs1csBatch(&lat2[i], sin, cos2, omc, m);
+		for (k = 0; k < m; k++) {
+			d[i + k] = angle(vlat[k], cos1[k], cos2[k], vlon[k]);
+		}
+	}
+}
@@ -0,0 +1,122 @@
+// Include <stddef.h> and <stdint.h> before this header.
+
+typedef struct {
+	/* Sine, cosine, 1-cosine */
+	double sin, cos, omc;
+} sincos1cos;
+
+typedef struct {
+	float sin, cos, omc;
+} sincos1cosf;
+
+// Bit patterns of IEEE 754 binary16 or of bfloat16 numbers.
+typedef struct {
+	uint16_t sin, cos, omc;
+} sincos1cos16;
+
+// sncs1cs is for |x| <= 2^30, and the infinities and NaNs: beyond, the
+// octant of x overflows an int, see sncs1cs.c. sncs1csf is for any x.
+sincos1cos sncs1cs(double);
+sincos1cosf sncs1csf(float);
+
+// sncs1cs for arrays of n numbers, with the same results. The output
+// arrays must not overlap the input array.
+void sncs1csBatch(const double *, double *, double *, double *, size_t);
+
+// sin(pi x), cos(pi x) and 1-cos(pi x), for single numbers and for
+// arrays of n numbers. The output arrays must not overlap the input
+// array.
+sincos1cos sncs1cspi(double);
+void sncs1cspiBatch(const double *, double *, double *, double *, size_t);
+
+typedef struct {
+	double tan, cot;
+} tancot;
+
+// tan(x) and cot(x), with the argument reduction of sncs1cs, for single
+// numbers and for arrays of n numbers. The output arrays must not
+// overlap the input array. They are for |x| < 2^26, and the infinities
+// and NaNs: beyond, the products with the parts of pi/4 of the
+// reduction are not exact, and beyond 2^30, the octant of x overflows
+// an int, as for sncs1cs.
+tancot tnct(double);
+void tnctBatch(const double *, double *, double *, size_t);
+
+// 1-cos(x), (1-cos(x))/2, and the great-circle distance on the unit
+// sphere between the points (lat1, lon1) and (lat2, lon2), in radians,
+// for single pairs of points and for arrays of n pairs. The output
+// array must not overlap the input arrays.
+double versin(double);
+double haversin(double);
+double hvdist(double, double, double, double);
+void hvdistBatch(const double *, const double *, const double *, const double *, double *, size_t);
+
+// Correctly rounded binary16 (h) and bfloat16 (b) versions, for single
+// numbers and for arrays of n numbers. The output arrays must not
+// overlap the input array.
+sincos1cos16 sncs1csh(uint16_t);
+sincos1cos16 sncs1csb(uint16_t);
+void sncs1cshBatch(const uint16_t *, uint16_t *, uint16_t *, uint16_t *, size_t);
+void sncs1csbBatch(const uint16_t *, uint16_t *, uint16_t *, uint16_t *, size_t);
+
+// Conversions, exact in the widening direction, rounding to nearest
+// (ties to even) in the narrowing one.
+float halfToFloat(uint16_t);
+uint16_t halfFromDouble(double);
+float bf16ToFloat(uint16_t);
+uint16_t bf16FromDouble(double);
+
+typedef struct {
+	long double sin, cos, omc;
+} sincos1cosl;
+
+sincos1cosl sncs1csl(long double);
+
+#ifdef __FLT128_MANT_DIG__
+typedef struct {
+	_Float128 sin, cos, omc;
+} sincos1cosq;
+
+sincos1cosq sncs1csq(_Float128);
+#endif
+
+typedef struct {
+	double exp, expm1;
+} expexpm1;
+
+// exp(x) and expm1(x), from one range reduction.
+expexpm1 exexm1(double);
+
+typedef struct {
+	double log, log1p;
+} loglog1p;
+
+// log(x) and log1p(x).
+loglog1p lglg1p(double);
+
+typedef struct {
+	double sinh, cosh, coshm1;
+} sinhcoshm1;
+
+// sinh(x), cosh(x) and cosh(x)-1, from one expm1.
+sinhcoshm1 snhcshm1(double);
+
+// A complex number, laid out like double _Complex.
+typedef struct {
+	double re, im;
+} cmplx;
+
+typedef struct {
+	cmplx sin, cos;
+} csincos;
+
+// The complex sine and cosine, and the complex exp, of re + im i; for
+// single numbers and for arrays of n numbers, either as separate arrays
+// of the real and imaginary parts or interleaved. The output arrays
+// must not overlap the input arrays.
+csincos csncs(double, double);
+cmplx cxexp(double, double);
+void csncsBatch(const double *, const double *, double *, double *, double *, double *, size_t);
+void csncsBatchI(const cmplx *, cmplx *, cmplx *, size_t);
+void cxexpBatch(const double *, const double *, double *, double *, size_t);
+void cxexpBatchI(const cmplx *, cmplx *, size_t);
@@ -0,0 +1,125 @@
+/* lglg1p gives both log(x) and log1p(x). Each of x and 1 + x is
+ * decomposed as 2^k (1 + f), with sqrt(2)/2 <= 1 + f < sqrt(2), and
+ * then, with s = f/(2 + f),
+ *
+ *	log1p(f) = 2 atanh(s) = f - f^2/2 + s (f^2/2 + R(s^2)),
+ *
+ * where R(z) = z T(z) for a minimax polynomial T (fit like the ones
+ * remez/ makes), so that the rounding errors of s only affect the
+ * small last term. This is the scheme of FreeBSD's (originally Sun's
+ * fdlibm) e_log.c and s_log1p.c, including the correction term for the
+ * rounding of 1 + x.
+ *
+ * The two evaluations share the code and constants, and are
+ * independent of each other, so they overlap in the pipeline.
+ */
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "kernels.h"
+
+static const double T[] = {
+	1.46168756835473141779E-1,
+	1.53316840101208740489E-1,
+	1.81828903689184662192E-1,
+	2.22222111158354783419E-1,
+	2.85714286261060879918E-1,
+	3.99999999998991756436E-1,
+	6.66666666666666969957E-1,
+};
+
+/* ln 2 = LN2HI + LN2LO, with 42 significant bits in LN2HI, so k*LN2HI
+ * is exact for all the k. */
+static const double LN2HI = 6.93147180559890330187E-1;
+static const double LN2LO = 5.49792301870837115524E-14;
+
+/* Decomposes x, which must be positive and finite, as 2^k (1 + f), and
+ * returns f. */
+static
+double
+decompose(double x, int *k) {
+	uint64_t u;
+	int e = 0;
+	memcpy(&u, &x, sizeof(u));
+	if ((u >> 52) == 0) {
+		/* Subnormal */
+		x *= 0x1p54;
+		memcpy(&u, &x, sizeof(u));
+		e = -54;
+	}
+	e += (int)(u >> 52) - 1023;
+	u = (u & 0x000fffffffffffffUL) | 0x3ff0000000000000UL;
+	/* Halve numbers above sqrt(2). */
+	if (u > 0x3ff6a09e667f3bcdUL) {
+		u -= 1UL << 52;
+		e++;
+	}
+	*k = e;
+	double m;
+	memcpy(&m, &u, sizeof(m));
+	return m - 1;
+}
+
+/* Returns s (f^2/2 + R(s^2)), and sets *hfsq to f^2/2. */
+static
+double
+tail(double f, double *hfsq) {
+	double s = f / (2 + f), z = s * s;
+	double t = T[0];
+	int i;
+	for (i = 1; i < (int)(sizeof(T) / sizeof(T[0])); i++) {
+		t = t*z + T[i];
+	}
+	*hfsq = 0.5 * f * f;
+	return s * (*hfsq + z*t);
+}
+
+loglog1p
+lglg1p(double x) {
+	loglog1p r;
+	double f, hfsq, t;
+	int k;
+
+	if (isnan(x)) {
+		r.log = r.log1p = x;
+		return r;
+	}
+
+	if (0 < x && x < HUGE_VAL) {
+		f = decompose(x, &k);
+		t = tail(f, &hfsq);
+		r.log = k*LN2HI - ((hfsq - (t + k*LN2LO)) - f);
+	} else if (x == 0) {
+		r.log = -HUGE_VAL;
+	} else if (x > 0) {
+		r.log = x;
+	} else {
+		r.log = NAN;
+	}
+
+	/* Handle +-0. */
+	if (x == 0) {
+		r.log1p = x;
+	} else if (-1 < x && x < HUGE_VAL) {
+		double u = 1 + x, c = 0;
+		f = decompose(u, &k);
+		/* c/u corrects for the rounding of u. The subtraction
+		 * from u is exact. */
+		if (k < 54) {
+			c = u >= 2 ? 1 - (u - x) : x - (u - 1);
+			c /= u;
+		}
+		t = tail(f, &hfsq);
+		r.log1p = k*LN2HI - ((hfsq - (t + (k*LN2LO + c))) - f);
+	} else if (x == -1) {
+		r.log1p = -HUGE_VAL;
+	} else if (x > 0) {
+		r.log1p = x;
+	} else {
+		r.log1p = NAN;
+	}
+	return r;
+}
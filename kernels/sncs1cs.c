@@ -0,0 +1,780 @@
+/* The following code (sincos1cos and float and double versions of
+ * sncs1cs) is Copyright © 1985, 1995, 2000 Stephen L. Moshier and
+ * Copyright © 2020 Neven Sajko. The intention is to get accurate
+ * 1-cosine, while also getting the sine and cosine as a bonus. The
+ * implementation is derived from the Cephes Math Library's sin.c and
+ * sinf.c. To be more specific, I took Stephen Moshier's sin, cos, sinf
+ * and cosf (without changing the polynomials) and adapted them to give
+ * all three required function values (in double and float versions),
+ * without unnecessary accuracy losses.
+ *
+ * sncs1cs is not correct for values of x of huge magnitude. That can
+ * be fixed by more elaborate range reduction. sncs1csf has that range
+ * reduction, for its arguments of magnitude greater than 65536.
+ */
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "kernels.h"
+
+typedef double mfloat_t;
+typedef int mint_t;
+
+static const double sc[] = {
+	1.58962301576546568060E-10,
+	-2.50507477628578072866E-8,
+	2.75573136213857245213E-6,
+	-1.98412698295895385996E-4,
+	8.33333333332211858878E-3,
+	-1.66666666666666307295E-1,
+};
+
+static const double cc[] = {
+	-1.13585365213876817300E-11,
+	2.08757008419747316778E-9,
+	-2.75573141792967388112E-7,
+	2.48015872888517045348E-5,
+	-1.38888888888730564116E-3,
+	4.16666666666665929218E-2,
+};
+
+/* The sc[] and cc[] polynomials in w, with Horner's rule over the
+ * whole tables, so that a table of another degree from remez/remez.c
+ * can be pasted in as it is. */
+static inline
+double
+sinPoly(double w) {
+	double p = sc[0];
+	size_t i;
+	for (i = 1; i < sizeof(sc) / sizeof(sc[0]); i++) {
+		p = p*w + sc[i];
+	}
+	return p;
+}
+
+static inline
+double
+omcPoly(double w) {
+	double p = cc[0];
+	size_t i;
+	for (i = 1; i < sizeof(cc) / sizeof(cc[0]); i++) {
+		p = p*w + cc[i];
+	}
+	return p;
+}
+
+static const double DP1 = 7.85398125648498535156E-1;
+static const double DP2 = 3.77489470793079817668E-8;
+static const double DP3 = 2.69515142907905952645E-15;
+
+/* The octant of x >= 0 for the range reduction of sncs1cs, rounded up
+ * to even (to map the zeros to the origin), in *y, and modulo one turn
+ * as the result. */
+static inline
+mint_t
+octant(mfloat_t x, mfloat_t *y) {
+	const mfloat_t fourOverPi = 1.27323954473516268615;
+
+	mint_t j = (mint_t)(x * fourOverPi);
+	j += j & 1;
+	*y = (mfloat_t)j;
+	return j & 7;
+}
+
+sincos1cos
+sncs1cs(mfloat_t x) {
+	mfloat_t y, z, zz;
+	mint_t j, sign = 1, csign = 1;
+	sincos1cos r;
+
+	/* Handle +-0. */
+	if (x == (mfloat_t)0) {
+		r.sin = x;
+		r.cos = 1;
+		r.omc = 0;
+		return r;
+	}
+	if (isnan(x)) {
+		r.sin = r.cos = r.omc = x;
+		return r;
+	}
+	if (isinf(x)) {
+		r.sin = r.cos = r.omc = x - x;
+		return r;
+	}
+	if (x < 0) {
+		sign = -1;
+		x = -x;
+	}
+	j = octant(x, &y);
+	/* reflect in x axis */
+	if (j > 3) {
+		sign = -sign;
+		csign = -csign;
+		j -= 4;
+	}
+	if (j > 1) {
+		csign = -csign;
+	}
+
+	/* Extended precision modular arithmetic */
+	z = ((x - y * DP1) - y * DP2) - y * DP3;
+	zz = z * z;
+	r.sin = z + zz*z*sinPoly(zz);
+	r.omc = (mfloat_t)0.5*zz - zz*zz*omcPoly(zz);
+
+	if (j == 1 || j == 2) {
+		if (csign < 0) {
+			r.sin = -r.sin;
+		}
+		r.cos = r.sin;
+		r.sin = 1 - r.omc;
+		r.omc = 1 - r.cos;
+	} else {
+		if (csign < 0) {
+			r.cos = r.omc - 1;
+			r.omc = 1 - r.cos;
+		} else {
+			r.cos = 1 - r.omc;
+		}
+	}
+	if (sign < 0) {
+		r.sin = -r.sin;
+	}
+	return r;
+}
+
+/* Bits of 4/pi, starting with the integer bit (the MSB of the first
+ * word). */
+static const uint64_t fourOverPiBits[] = {
+	0xa2f9836e4e441529UL,
+	0xfc2757d1f534ddc0UL,
+	0xdb6295993c439041UL,
+	0xfe5163abdebbc561UL,
+};
+
+/* The 64 bits of 4/pi starting with bit i, which may be negative. */
+static
+uint64_t
+fourOverPiAt(int i) {
+	if (i <= -64) {
+		return 0;
+	}
+	if (i < 0) {
+		return fourOverPiBits[0] >> -i;
+	}
+	int w = i / 64, s = i % 64;
+	uint64_t r = fourOverPiBits[w] << s;
+	if (s != 0) {
+		r |= fourOverPiBits[w + 1] >> (64 - s);
+	}
+	return r;
+}
+
+/* Double precision sine, cosine and 1-cosine of any finite float,
+ * with Payne and Hanek's range reduction: for x = m 2^e, only the bits
+ * of 4/pi from bit e-2 on influence x*4/pi modulo 8, so a 128 bit
+ * window of them is multiplied by the integer m. */
+static
+sincos1cos
+sncs1csLarge(float x) {
+	uint32_t u;
+	memcpy(&u, &x, sizeof(u));
+	int neg = u >> 31, e = (int)((u >> 23) & 0xff);
+	uint64_t m = u & 0x7fffff;
+	if (e == 0) {
+		e = 1;
+	} else {
+		m |= 0x800000;
+	}
+	e -= 127 + 23;
+
+	/* x*4/pi = m*w 2^-125 modulo 8 */
+	uint64_t wHi = fourOverPiAt(e - 2), wLo = fourOverPiAt(e - 2 + 64);
+	unsigned __int128 lo = (unsigned __int128)m * wLo;
+	unsigned __int128 t = (unsigned __int128)m * wHi + (uint64_t)(lo >> 64);
+	int j = (int)(t >> 61) & 7;
+	uint64_t frac = (uint64_t)(t << 3) | (uint64_t)lo >> 61;
+
+	/* map zeros to origin */
+	double z;
+	if ((j & 1)) {
+		j = (j + 1) & 7;
+		z = -(double)(0 - frac);
+	} else {
+		z = (double)frac;
+	}
+	z *= 0x1p-64 * 7.85398163397448309616E-1;
+
+	double zz = z * z;
+	double s = z + zz*z*sinPoly(zz);
+	double o = 0.5*zz - zz*zz*omcPoly(zz);
+
+	sincos1cos r;
+	switch (j >> 1) {
+	case 0:
+		r.sin = s;
+		r.cos = 1 - o;
+		r.omc = o;
+		break;
+	case 1:
+		r.sin = 1 - o;
+		r.cos = -s;
+		r.omc = 1 + s;
+		break;
+	case 2:
+		r.sin = -s;
+		r.cos = o - 1;
+		r.omc = 2 - o;
+		break;
+	default:
+		r.sin = o - 1;
+		r.cos = s;
+		r.omc = 1 - s;
+		break;
+	}
+	if (neg) {
+		r.sin = -r.sin;
+	}
+	return r;
+}
+
+static
+float
+floatFromBits(uint32_t u) {
+	float f;
+	memcpy(&f, &u, sizeof(f));
+	return f;
+}
+
+static
+uint32_t
+floatBits(float f) {
+	uint32_t u;
+	memcpy(&u, &f, sizeof(u));
+	return u;
+}
+
+/* c ? a : b, done with bit masks as the compiler must otherwise keep
+ * the computation of a and b in branches, in case they trap. */
+static inline
+float
+selectf(int c, float a, float b) {
+	uint32_t m = -(uint32_t)(c != 0);
+	return floatFromBits((floatBits(a) & m) | (floatBits(b) & ~m));
+}
+
+/* Arguments up to this magnitude are reduced in float by sncs1csf. */
+static const float lossth = 65536;
+
+/* The float version for |x| <= lossth. The octant is selected without
+ * branches, so that loops over this can be vectorized. */
+static inline
+sincos1cosf
+sncs1csfSmall(float x) {
+	const float fourOverPi = 1.27323954473516f;
+
+	float ax = fabsf(x);
+	int j = (int)(ax * fourOverPi);
+	/* map zeros to origin */
+	j += j & 1;
+	double y = (double)j;
+	int q = (j >> 1) & 3; /* quadrant modulo one turn */
+
+	/* Extended precision modular arithmetic, done in double so that
+	 * the result stays accurate near the zeros of sin and cos. */
+	float z = (float)(((ax - y * DP1) - y * DP2) - y * DP3);
+	float zz = z * z;
+	float s = z + zz*z*((-1.9515295891E-4f*zz + 8.3321608736E-3f)*zz - 1.6666654611E-1f);
+	float o = 0.5f*zz - zz*zz*((2.443315711809948E-5f*zz - 1.388731625493765E-3f)*zz + 4.166664568298827E-2f);
+
+	/* The signs of the sine and of the cosine for each quadrant, and
+	 * the sign of x, are applied with (exact) multiplications. */
+	int odd = q & 1;
+	float sinSign = (float)(1 - (int)(((floatBits(x) >> 31) ^ (q >> 1)) << 1));
+	float cosSign = (float)(1 - ((q + 1) & 2));
+	float omo = 1 - o;
+
+	sincos1cosf r;
+	r.sin = sinSign * selectf(odd, omo, s);
+	r.cos = cosSign * selectf(odd, s, omo);
+	r.omc = selectf(odd, 1 - r.cos, (float)(q & 2) + cosSign * o);
+	return r;
+}
+
+sincos1cosf
+sncs1csf(float x) {
+	if (fabsf(x) <= lossth) {
+		return sncs1csfSmall(x);
+	}
+	sincos1cosf r;
+	if (!isfinite(x)) {
+		r.sin = r.cos = r.omc = x - x;
+		return r;
+	}
+	sincos1cos d = sncs1csLarge(x);
+	r.sin = (float)d.sin;
+	r.cos = (float)d.cos;
+	r.omc = (float)d.omc;
+	return r;
+}
+
+/* sncs1cs of a float argument, correct for huge ones too. */
+static
+sincos1cos
+sncs1csWide(float x) {
+	if (fabsf(x) <= lossth || !isfinite(x)) {
+		return sncs1cs(x);
+	}
+	return sncs1csLarge(x);
+}
+
+/* Branch free, see Marat Dukhan's FP16 library: normal numbers are
+ * rebiased with an integer addition followed by a multiplication that
+ * also takes care of infinities and NaNs, subnormal ones are converted
+ * through a float with a known exponent. */
+float
+halfToFloat(uint16_t h) {
+	uint32_t w = (uint32_t)h << 16, sign = w & 0x80000000, w2 = w + w;
+	uint32_t normalized = floatBits(floatFromBits((w2 >> 4) + (0xe0u << 23)) * 0x1p-112f);
+	uint32_t subnormal = floatBits(floatFromBits((w2 >> 17) | (126u << 23)) - 0.5f);
+	uint32_t mask = -(uint32_t)(w2 < (1u << 27));
+	return floatFromBits(sign | (subnormal & mask) | (normalized & ~mask));
+}
+
+float
+bf16ToFloat(uint16_t b) {
+	return floatFromBits((uint32_t)b << 16);
+}
+
+/* Rounds x to the binary interchange-style format with mbits stored
+ * significand bits and ebits exponent bits. */
+static
+uint16_t
+narrowFromDouble(double x, int mbits, int ebits) {
+	uint64_t u;
+	memcpy(&u, &x, sizeof(u));
+	uint16_t sign = (uint16_t)(u >> 48) & 0x8000;
+	uint16_t inf = (uint16_t)(((1u << ebits) - 1) << mbits);
+	u &= ~(1UL << 63);
+	if (0x7ff0000000000000UL < u) {
+		/* quiet NaN */
+		return sign | inf | (uint16_t)(1u << (mbits - 1));
+	}
+	int bias = (1 << (ebits - 1)) - 1, e = (int)(u >> 52) - 1023;
+	if (bias < e) {
+		return sign | inf;
+	}
+	if (e == -1023) {
+		/* Too small for any of the formats. */
+		return sign;
+	}
+
+	/* Drop the bits below the quantum of the result, which is 2^(e -
+	 * mbits), or 2^(1 - bias - mbits) for subnormal results. */
+	uint64_t m = (u & 0xfffffffffffffUL) | (1UL << 52);
+	int shift = 52 - mbits + (e < 1 - bias ? 1 - bias - e : 0);
+	if (63 < shift) {
+		return sign;
+	}
+	uint64_t r = m >> shift, rem = m & ((1UL << shift) - 1), half = 1UL << (shift - 1);
+	if (half < rem || (rem == half && (r & 1))) {
+		r++;
+	}
+	/* A carry out of the significand increments the exponent, possibly
+	 * to that of infinity, as it should. */
+	int be = e < 1 - bias ? 0 : e + bias - 1;
+	return sign | (uint16_t)(((uint64_t)be << mbits) + r);
+}
+
+uint16_t
+halfFromDouble(double x) {
+	return narrowFromDouble(x, 10, 5);
+}
+
+uint16_t
+bf16FromDouble(double x) {
+	return narrowFromDouble(x, 7, 8);
+}
+
+/* Rounding of the magnitude bits of a float to binary16 (as in the
+ * FP16 library again, adding 1/2 makes the FPU round subnormals). */
+static inline
+uint16_t
+halfFromFloatBits(uint32_t mag) {
+	if (0x47800000 <= mag) {
+		return 0x7f800000 < mag ? 0x7e00 : 0x7c00;
+	}
+	if (mag < 0x38800000) {
+		return (uint16_t)(floatBits(floatFromBits(mag) + 0.5f) - floatBits(0.5f));
+	}
+	return (uint16_t)((mag - ((127u - 15) << 23) + 0xfff + ((mag >> 13) & 1)) >> 13);
+}
+
+/* Rounding of the magnitude bits of a finite float to bfloat16. */
+static inline
+uint16_t
+bf16FromFloatBits(uint32_t mag) {
+	return (uint16_t)((mag + 0x7fff + ((mag >> 16) & 1)) >> 16);
+}
+
+/* Bound on the error of sncs1csf, in float ULPs of the result. */
+static const uint32_t errUlps = 8;
+
+/* Rounds v, which approximates some value with an error of at most
+ * errUlps, to the narrow format. Returns zero when that doesn't
+ * determine the rounding of the approximated value (Ziv's test). The
+ * neighbours of v are found by stepping its bit pattern, twice as far
+ * downwards in case that crosses into a binade with smaller ULPs. */
+static inline
+int
+roundNarrow(float v, uint16_t *r, int ebits) {
+	uint32_t u = floatBits(v), mag = u & 0x7fffffff;
+	uint16_t sign = (uint16_t)(u >> 16) & 0x8000;
+	if (ebits == 5) {
+		*r = sign | halfFromFloatBits(mag);
+		return 0x7f800000 <= mag ||
+			(2*errUlps <= mag && halfFromFloatBits(mag - 2*errUlps) == halfFromFloatBits(mag + errUlps));
+	}
+	if (0x7f800000 <= mag) {
+		*r = sign | (uint16_t)(mag >> 16) | (0x7f800000 < mag ? 0x40 : 0);
+		return 1;
+	}
+	*r = sign | bf16FromFloatBits(mag);
+	return 2*errUlps <= mag && bf16FromFloatBits(mag - 2*errUlps) == bf16FromFloatBits(mag + errUlps);
+}
+
+static
+sincos1cos16
+narrowSncs1cs(float x, int mbits, int ebits) {
+	sincos1cosf f = sncs1csf(x);
+	sincos1cos16 r;
+	if (roundNarrow(f.sin, &r.sin, ebits) &
+	    roundNarrow(f.cos, &r.cos, ebits) &
+	    roundNarrow(f.omc, &r.omc, ebits)) {
+		return r;
+	}
+	/* The float results are too close to a rounding boundary of the
+	 * narrow format, redo it in double. */
+	sincos1cos d = sncs1csWide(x);
+	r.sin = narrowFromDouble(d.sin, mbits, ebits);
+	r.cos = narrowFromDouble(d.cos, mbits, ebits);
+	r.omc = narrowFromDouble(d.omc, mbits, ebits);
+	return r;
+}
+
+sincos1cos16
+sncs1csh(uint16_t x) {
+	return narrowSncs1cs(halfToFloat(x), 10, 5);
+}
+
+sincos1cos16
+sncs1csb(uint16_t x) {
+	return narrowSncs1cs(bf16ToFloat(x), 7, 8);
+}
+
+enum {
+	/* Elements handled in one go by the batch functions. */
+	BatchLanes = 64,
+};
+
+/* Widens a block of arguments, runs sncs1csfSmall over all of them at
+ * once, and then rounds the results, leaving the arguments out of the
+ * reach of sncs1csfSmall, and any results that fail the rounding test,
+ * to the scalar code. */
+static
+void
+narrowBatch(const uint16_t *restrict x, uint16_t *restrict sin, uint16_t *restrict cos, uint16_t *restrict omc,
+		size_t n, int mbits, int ebits) {
+	float xf[BatchLanes], s[BatchLanes], c[BatchLanes], o[BatchLanes];
+	size_t i, k, m;
+	for (i = 0; i < n; i += m) {
+		m = n - i < BatchLanes ? n - i : BatchLanes;
+		if (ebits == 5) {
+			for (k = 0; k < m; k++) {
+				xf[k] = halfToFloat(x[i + k]);
+			}
+		} else {
+			for (k = 0; k < m; k++) {
+				xf[k] = bf16ToFloat(x[i + k]);
+			}
+		}
+		for (k = 0; k < m; k++) {
+			sincos1cosf r = sncs1csfSmall(selectf(fabsf(xf[k]) <= lossth, xf[k], 0));
+			s[k] = r.sin;
+			c[k] = r.cos;
+			o[k] = r.omc;
+		}
+		for (k = 0; k < m; k++) {
+			if (!(fabsf(xf[k]) <= lossth) ||
+			    !(roundNarrow(s[k], &sin[i + k], ebits) &
+			      roundNarrow(c[k], &cos[i + k], ebits) &
+			      roundNarrow(o[k], &omc[i + k], ebits))) {
+				sincos1cos16 r = narrowSncs1cs(xf[k], mbits, ebits);
+				sin[i + k] = r.sin;
+				cos[i + k] = r.cos;
+				omc[i + k] = r.omc;
+			}
+		}
+	}
+}
+
+void
+sncs1cshBatch(const uint16_t *x, uint16_t *sin, uint16_t *cos, uint16_t *omc, size_t n) {
+	narrowBatch(x, sin, cos, omc, n, 10, 5);
+}
+
+void
+sncs1csbBatch(const uint16_t *x, uint16_t *sin, uint16_t *cos, uint16_t *omc, size_t n) {
+	narrowBatch(x, sin, cos, omc, n, 7, 8);
+}
+
+static inline
+double
+doubleFromBits(uint64_t u) {
+	double d;
+	memcpy(&d, &u, sizeof(d));
+	return d;
+}
+
+static inline
+uint64_t
+doubleBits(double d) {
+	uint64_t u;
+	memcpy(&u, &d, sizeof(u));
+	return u;
+}
+
+/* c ? a : b for c = 0 or 1, like selectf. The condition is as wide as
+ * the operands, as otherwise GCC does not vectorize the loops. */
+static inline
+double
+selectd(int64_t c, double a, double b) {
+	uint64_t m = -(uint64_t)c;
+	return doubleFromBits((doubleBits(a) & m) | (doubleBits(b) & ~m));
+}
+
+/* pi split into a 26 bit head, the rest of its double value, and the
+ * double nearest to what remains of pi. */
+static const double PIH = 3.14159262180328369141E0;
+static const double PIL = 3.17865094245917134685E-8;
+static const double PIL2 = 1.22464679914735320717E-16;
+
+/* sin(pi x), cos(pi x) and 1 - cos(pi x). The reduction, x = n + q/2 + y
+ * with an integer n, q in {-1, 0, 1} and |y| <= 1/4, is exact: x - n
+ * always is, and so is subtracting q/2 by Sterbenz's lemma, as then
+ * 1/4 <= |x - n| <= 1/2. The product z = pi y is then computed with an
+ * error much below its last bit, from the exact product of the 26 bit
+ * heads of pi and y. As for sncs1csfSmall, there are no branches, not
+ * even for infinities and NaNs, which are replaced by zero for the
+ * reduction and then poison the results. */
+static inline
+sincos1cos
+sncs1cspiAny(double x) {
+	double nan0 = x - x;
+	double xx = selectd(nan0 == 0, x, 0);
+	double n = rint(xx), f = xx - n, q = rint(2 * f), y = f - 0.5*q;
+
+	/* The parity of n, in {-1, 0, 1}; n/2 is exact, as is the rest. */
+	double h = n - 2*rint(0.5 * n);
+	int j = (int)(2*h + q) & 3; /* quadrant modulo one turn */
+
+	double yh = doubleFromBits(doubleBits(y) & ~(uint64_t)0x7ffffff), yl = y - yh;
+	double zh = yh * PIH, zl = (yh*PIL + yl*(PIH + PIL)) + y*PIL2;
+	double z = zh + zl, zz = z * z;
+	zl -= z - zh;
+	double s = z + (zl + zz*z*sinPoly(zz));
+	double o = 0.5*zz + z*zl - zz*zz*omcPoly(zz);
+
+	int64_t odd = j & 1;
+	double sinSign = (double)(1 - (j & 2));
+	double cosSign = (double)(1 - ((j + 1) & 2));
+	double omo = 1 - o;
+
+	sincos1cos r;
+	r.sin = sinSign * selectd(odd, omo, s) + nan0;
+	/* Adding zero turns the -0 of cos(pi/2) into +0. */
+	r.cos = cosSign * selectd(odd, s, omo) + nan0;
+	r.omc = selectd(odd, 1 - r.cos, (double)(j & 2) + cosSign * o) + nan0;
+	/* sin(pi n) is zero with the sign of n. */
+	r.sin = selectd(r.sin == 0, copysign(0, x), r.sin);
+	return r;
+}
+
+sincos1cos
+sncs1cspi(double x) {
+	return sncs1cspiAny(x);
+}
+
+void
+sncs1cspiBatch(const double *restrict x, double *restrict sin, double *restrict cos, double *restrict omc, size_t n) {
+	size_t i;
+	for (i = 0; i < n; i++) {
+		sincos1cos r = sncs1cspiAny(x[i]);
+		sin[i] = r.sin;
+		cos[i] = r.cos;
+		omc[i] = r.omc;
+	}
+}
+
+/* The rational approximation of tan on [0, pi/4] from the Cephes Math
+ * Library's tan.c (Copyright © 1984, 1995, 2000 Stephen L. Moshier):
+ * tan(z) = z + z^3 P(z^2)/Q(z^2). */
+static const double tp[] = {
+	-1.30936939181383777646E4,
+	1.15351664838587416140E6,
+	-1.79565251976484877988E7,
+};
+
+/* Monic, the leading 1 is left out. */
+static const double tq[] = {
+	1.36812963470692954678E4,
+	-1.32089234440210967447E6,
+	2.50083801823357915839E7,
+	-5.38695755929454629881E7,
+};
+
+/* Returns a + b, rounded, and sets *e to the rounding error. */
+static inline
+double
+twoSum(double a, double b, double *e) {
+	double s = a + b, bb = s - a;
+	*e = (a - (s - bb)) + (b - bb);
+	return s;
+}
+
+/* Returns a*b, rounded, and sets *e to the rounding error, with
+ * Dekker's product (as a and b are split into halves with Veltkamp's
+ * method, their products are exact). */
+static inline
+double
+twoProd(double a, double b, double *e) {
+	const double split = 134217729; /* 2^27 + 1 */
+
+	double p = a * b;
+	double ca = split * a, ah = ca - (ca - a), al = a - ah;
+	double cb = split * b, bh = cb - (cb - b), bl = b - bh;
+	*e = ((ah*bh - p) + ah*bl + al*bh) + al*bl;
+	return p;
+}
+
+/* pi/4 in four parts, the first three of 26 bits. (Cephes's tan.c has
+ * the first two, and the rest in one.) */
+static const double TP1 = 7.85398155450820922852E-1;
+static const double TP2 = 7.94662735614792836714E-9;
+static const double TP3 = 3.06161696602679712551E-17;
+static const double TP4 = 3.18415858175547495398E-25;
+
+/* tan(x) and cot(x), with the octants of sncs1cs. Near the poles of
+ * either the reduced argument is tiny, so it is reduced with one more
+ * part of pi/4 than in sncs1cs: for |x| < 2^26, the products with the
+ * first three parts are exact. The rounding errors of the subtractions
+ * are kept, and so is that of the rational function, for the
+ * reciprocal, which is then corrected with the residual of the
+ * division.
+ *
+ * Of tan and cot, one is the rational function of the reduced argument
+ * and the other is its reciprocal, up to sign, so there is just one
+ * division besides that of the rational function. There are no
+ * branches, like in sncs1cspiAny, so there is no fallback for huge x:
+ * finite x must be of magnitude less than 2^26, see kernels.h. */
+static inline
+tancot
+tnctAny(double x) {
+	double nan0 = x - x;
+	double ax = selectd(nan0 == 0, fabs(x), 0), y;
+	int j = octant(ax, &y);
+	/* The reduced argument is z + zl, with the rounding errors of the
+	 * subtractions in zl. */
+	double e2, e3, e4;
+	double z = twoSum(twoSum(twoSum(ax - y * TP1, -y * TP2, &e2), -y * TP3, &e3), -y * TP4, &e4);
+	double zl = e2 + e3 + e4, zz = z * z;
+
+	/* tan(z + zl) = t + tl, with tan' = 1 + tan^2 for the zl term. */
+	double c = z*(zz*((tp[0]*zz + tp[1])*zz + tp[2]) / ((((zz + tq[0])*zz + tq[1])*zz + tq[2])*zz + tq[3]));
+	double v = z + c;
+	c += zl * (1 + v*v);
+	double t = z + c, tl = c - (t - z);
+
+	/* 1/(t + tl) = u + u (1 - u (t + tl)), nearly, with the product u t
+	 * exact. For tiny t, u is too large for the split of twoProd, or
+	 * infinite, and is kept as it is: the correction would be NaN. */
+	double u = 1 / t, pe, p = twoProd(u, t, &pe);
+	u = selectd(fabs(u) < 0x1p996, u + u * (((1 - p) - pe) - u*tl), u);
+
+	/* The period is pi, so only the parity of the quadrant matters. */
+	int64_t odd = (j >> 1) & 1;
+	double sign = copysign(1, x);
+
+	tancot r;
+	r.tan = selectd(nan0 == 0, sign * selectd(odd, -u, t), nan0);
+	r.cot = selectd(nan0 == 0, sign * selectd(odd, -t, u), nan0);
+	return r;
+}
+
+tancot
+tnct(double x) {
+	return tnctAny(x);
+}
+
+void
+tnctBatch(const double *restrict x, double *restrict tan, double *restrict cot, size_t n) {
+	size_t i;
+	for (i = 0; i < n; i++) {
+		tancot r = tnctAny(x[i]);
+		tan[i] = r.tan;
+		cot[i] = r.cot;
+	}
+}
+
+/* Arguments up to this magnitude are handled by sncs1csSmall, as by
+ * the branch for them in Cephes's sin.c. */
+static const double dlossth = 1.073741824e9;
+
+/* sncs1cs for |x| <= dlossth, with the octant selected without
+ * branches, like in sncs1csfSmall. The results are the same as those
+ * of sncs1cs. */
+static inline
+sincos1cos
+sncs1csSmall(double x) {
+	double ax = fabs(x), y;
+	int q = octant(ax, &y) >> 1;
+	int64_t odd = q & 1, q0 = q == 0;
+
+	/* Extended precision modular arithmetic */
+	double z = ((ax - y * DP1) - y * DP2) - y * DP3, zz = z * z;
+	double s = z + zz*z*sinPoly(zz);
+	double o = 0.5*zz - zz*zz*omcPoly(zz);
+
+	double sinSign = (double)(1 - (q & 2)) * copysign(1, x);
+	double cosSign = (double)(1 - ((q + 1) & 2));
+	double omo = 1 - o;
+
+	sincos1cos r;
+	r.sin = sinSign * selectd(odd, omo, s);
+	r.cos = cosSign * selectd(odd, s, omo);
+	r.omc = selectd(q0, o, 1 - r.cos);
+	return r;
+}
+
+void
+sncs1csBatch(const double *restrict x, double *restrict sin, double *restrict cos, double *restrict omc, size_t n) {
+	size_t i;
+	for (i = 0; i < n; i++) {
+		sincos1cos r = sncs1csSmall(selectd(fabs(x[i]) <= dlossth, x[i], 0));
+		sin[i] = r.sin;
+		cos[i] = r.cos;
+		omc[i] = r.omc;
+	}
+	for (i = 0; i < n; i++) {
+		if (!(fabs(x[i]) <= dlossth)) {
+			sincos1cos r = sncs1cs(x[i]);
+			sin[i] = r.sin;
+			cos[i] = r.cos;
+			omc[i] = r.omc;
+		}
+	}
+}
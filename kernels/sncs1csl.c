@@ -0,0 +1,280 @@
+/* Extended precision versions of sncs1cs: sncs1csl for the x87 80 bit
+ * long double, and sncs1csq for IEEE 754 binary128 (_Float128). They
+ * follow sncs1cs, with polynomials of higher degree (minimax fits made
+ * as with remez/, in relative error) and π/4 split into four parts for
+ * the Cody-Waite reduction.
+ *
+ * The reduction is exact for arguments of magnitude less than 2^31
+ * (long double) or 2^56 (binary128), greater arguments get less
+ * accurate results.
+ */
+
+#define __STDC_WANT_IEC_60559_TYPES_EXT__
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "kernels.h"
+
+static const long double scl[] = {
+	2.7912257249818867980898925207753152571825E-15L,
+	-7.6469609520607168845231893750825087900644E-13L,
+	1.6059042777690813296130068083194931114245E-10L,
+	-2.5052108382375744406088681434124833809895E-8L,
+	2.7557319223981069035833797249504094778911E-6L,
+	-1.9841269841269837544514293699963298049743E-4L,
+	8.3333333333333333322361886382422113748350E-3L,
+	-1.6666666666666666666666136125340753506292E-1L,
+};
+
+static const long double ccl[] = {
+	-1.5518049366637193945118817294584243958779E-16L,
+	4.7793759692271040562859341298766270314992E-14L,
+	-1.1470745068504277555571685620731203111298E-11L,
+	2.0876756986336829644577141159719397026997E-9L,
+	-2.7557319223983483972858137183232674744427E-7L,
+	2.4801587301587299729197438136181737581013E-5L,
+	-1.3888888888888888888342168086088656303085E-3L,
+	4.1666666666666666666666402605214343327071E-2L,
+};
+
+/* π/4 = DP1l + DP2l + DP3l + DP4l, with 32 significant bits in each of
+ * the first three parts, so y*DP1l, y*DP2l and y*DP3l are exact for
+ * integers y < 2^32. */
+static const long double DP1l = 0x1.921fb544p-1L;
+static const long double DP2l = 0x1.0b4611a6p-35L;
+static const long double DP3l = 0x1.3198a2e0p-70L;
+static const long double DP4l = 0x1.b839a252049c1114p-105L;
+
+/* Evaluates the polynomial with the coefficients c[0], ..., c[n],
+ * highest degree first, at x. */
+static
+long double
+polevll(long double x, const long double *c, int n) {
+	long double r = c[0];
+	int i;
+	for (i = 1; i <= n; i++) {
+		r = r*x + c[i];
+	}
+	return r;
+}
+
+/* Returns a + b, rounded, and sets *e to the rounding error. */
+static
+long double
+twoSuml(long double a, long double b, long double *e) {
+	long double s = a + b, bb = s - a;
+	*e = (a - (s - bb)) + (b - bb);
+	return s;
+}
+
+sincos1cosl
+sncs1csl(long double x) {
+	const long double fourOverPi = 1.27323954473516268615107010698011489627567716592L;
+
+	long double y, z, zz, e1, e2;
+	int j, sign = 1, csign = 1;
+	sincos1cosl r;
+
+	/* Handle +-0. */
+	if (x == 0) {
+		r.sin = x;
+		r.cos = 1;
+		r.omc = 0;
+		return r;
+	}
+	if (isnan(x)) {
+		r.sin = r.cos = r.omc = x;
+		return r;
+	}
+	if (isinf(x)) {
+		r.sin = r.cos = r.omc = x - x;
+		return r;
+	}
+	if (x < 0) {
+		sign = -1;
+		x = -x;
+	}
+	y = floorl(x * fourOverPi);
+	j = (int)fmodl(y, 8);
+	/* map zeros to origin */
+	if ((j & 1)) {
+		j += 1;
+		y += 1;
+	}
+	j = j & 7; /* octant modulo one turn */
+	/* reflect in x axis */
+	if (j > 3) {
+		sign = -sign;
+		csign = -csign;
+		j -= 4;
+	}
+	if (j > 1) {
+		csign = -csign;
+	}
+
+	/* Extended precision modular arithmetic. The rounding errors
+	 * of the middle steps are kept, so that there is just one of
+	 * the magnitude of z. */
+	z = twoSuml(x - y * DP1l, -(y * DP2l), &e1);
+	z = twoSuml(z, -(y * DP3l), &e2);
+	z = z - (y * DP4l - (e1 + e2));
+	zz = z * z;
+	r.sin = z + zz*z*polevll(zz, scl, 7);
+	r.omc = 0.5L*zz - zz*zz*polevll(zz, ccl, 7);
+
+	if (j == 1 || j == 2) {
+		if (csign < 0) {
+			r.sin = -r.sin;
+		}
+		r.cos = r.sin;
+		r.sin = 1 - r.omc;
+		r.omc = 1 - r.cos;
+	} else {
+		if (csign < 0) {
+			r.cos = r.omc - 1;
+			r.omc = 1 - r.cos;
+		} else {
+			r.cos = 1 - r.omc;
+		}
+	}
+	if (sign < 0) {
+		r.sin = -r.sin;
+	}
+	return r;
+}
+
+#ifdef __FLT128_MANT_DIG__
+static const _Float128 scq[] = {
+	6.4130262942313844427880307899803090956547E-26f128,
+	-3.8681152487487668069472801912315690653893E-23f128,
+	1.9572940552352094919363965113311932302640E-20f128,
+	-8.2206352463227091867281686979014151468483E-18f128,
+	2.8114572543454031646625479452061135714464E-15f128,
+	-7.6471637318198161700062085996731684927408E-13f128,
+	1.6059043836821614598868544817717473346088E-10f128,
+	-2.5052108385441718775051539669693934019978E-8f128,
+	2.7557319223985890652557318859643929871344E-6f128,
+	-1.9841269841269841269841269841149235327138E-4f128,
+	8.3333333333333333333333333333333176942690E-3f128,
+	-1.6666666666666666666666666666666666663309E-1f128,
+};
+
+static const _Float128 ccq[] = {
+	-2.4674810693983185922542642692181804188915E-27f128,
+	1.6117179604606429743764003412834764297329E-24f128,
+	-8.8967912100187772234949843605244812811417E-22f128,
+	4.1103176232045207034626742146263420987052E-19f128,
+	-1.5619206968585806898146132440229755674472E-16f128,
+	4.7794773323873851883399841524147007623113E-14f128,
+	-1.1470745597729724713664945476431500083901E-11f128,
+	2.0876756987868098979209887658356009718675E-9f128,
+	-2.7557319223985890652557319094218939981565E-7f128,
+	2.4801587301587301587301587301544371222706E-5f128,
+	-1.3888888888888888888888888888888883325950E-3f128,
+	4.1666666666666666666666666666666666665473E-2f128,
+};
+
+/* As for long double, but with 56 bits in the first three parts, so
+ * the products are exact for integers y < 2^57. */
+static const _Float128 DP1q = 0x1.921fb54442d184p-1f128;
+static const _Float128 DP2q = 0x1.a62633145c06e0p-59f128;
+static const _Float128 DP3q = 0x1.cd129024e088a6p-116f128;
+static const _Float128 DP4q = 0x1.f31d0082efa98ec4e6c89452821ep-174f128;
+
+static
+_Float128
+polevlq(_Float128 x, const _Float128 *c, int n) {
+	_Float128 r = c[0];
+	int i;
+	for (i = 1; i <= n; i++) {
+		r = r*x + c[i];
+	}
+	return r;
+}
+
+static
+_Float128
+twoSumq(_Float128 a, _Float128 b, _Float128 *e) {
+	_Float128 s = a + b, bb = s - a;
+	*e = (a - (s - bb)) + (b - bb);
+	return s;
+}
+
+sincos1cosq
+sncs1csq(_Float128 x) {
+	const _Float128 fourOverPi = 1.27323954473516268615107010698011489627567716592f128;
+
+	_Float128 y, z, zz, e1, e2;
+	int j, sign = 1, csign = 1;
+	sincos1cosq r;
+
+	/* Handle +-0. */
+	if (x == 0) {
+		r.sin = x;
+		r.cos = 1;
+		r.omc = 0;
+		return r;
+	}
+	if (isnan(x)) {
+		r.sin = r.cos = r.omc = x;
+		return r;
+	}
+	if (isinf(x)) {
+		r.sin = r.cos = r.omc = x - x;
+		return r;
+	}
+	if (x < 0) {
+		sign = -1;
+		x = -x;
+	}
+	y = floorf128(x * fourOverPi);
+	j = (int)fmodf128(y, 8);
+	/* map zeros to origin */
+	if ((j & 1)) {
+		j += 1;
+		y += 1;
+	}
+	j = j & 7; /* octant modulo one turn */
+	/* reflect in x axis */
+	if (j > 3) {
+		sign = -sign;
+		csign = -csign;
+		j -= 4;
+	}
+	if (j > 1) {
+		csign = -csign;
+	}
+
+	/* Extended precision modular arithmetic. The rounding errors
+	 * of the middle steps are kept, so that there is just one of
+	 * the magnitude of z. */
+	z = twoSumq(x - y * DP1q, -(y * DP2q), &e1);
+	z = twoSumq(z, -(y * DP3q), &e2);
+	z = z - (y * DP4q - (e1 + e2));
+	zz = z * z;
+	r.sin = z + zz*z*polevlq(zz, scq, 11);
+	r.omc = 0.5f128*zz - zz*zz*polevlq(zz, ccq, 11);
+
+	if (j == 1 || j == 2) {
+		if (csign < 0) {
+			r.sin = -r.sin;
+		}
+		r.cos = r.sin;
+		r.sin = 1 - r.omc;
+		r.omc = 1 - r.cos;
+	} else {
+		if (csign < 0) {
+			r.cos = r.omc - 1;
+			r.omc = 1 - r.cos;
+		} else {
+			r.cos = 1 - r.omc;
+		}
+	}
+	if (sign < 0) {
+		r.sin = -r.sin;
+	}
+	return r;
+}
+#endif
@@ -0,0 +1,70 @@
+/* snhcshm1 is the hyperbolic analogue of sncs1cs: it gives sinh(x),
+ * cosh(x) and cosh(x)-1, all from t = expm1(|x|) (see exexm1), without
+ * cancellation:
+ *
+ *	sinh(|x|) = (t + t/(t + 1))/2 = (2t - t^2/(t + 1))/2,
+ *	cosh(x) - 1 = (t - t/(t + 1))/2,
+ *	cosh(x) = 1 + (cosh(x) - 1).
+ *
+ * Like FreeBSD's (originally Sun's fdlibm) e_sinh.c, the second form of
+ * sinh is used for |x| < 1. There cosh(x)-1 is summed as its Taylor
+ * series instead, like the omc polynomial of sncs1cs, as its form above
+ * cancels. Beyond 22, e^-|x| is negligible, and past the exp overflow
+ * threshold the results are computed from exp(|x|/2), as in e_sinh.c.
+ */
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "kernels.h"
+
+// 1/(2k)! for k = 10, 9, ..., 2: enough terms for |x| < 1.
+static const double hc[] = {
+	4.11031762331216484407E-19,
+	1.56192069685862252711E-16,
+	4.77947733238738525345E-14,
+	1.14707455977297245073E-11,
+	2.08767569878681001866E-9,
+	2.75573192239858882758E-7,
+	2.48015873015873015658E-5,
+	1.38888888888888894189E-3,
+	4.16666666666666643537E-2,
+};
+
+sinhcoshm1
+snhcshm1(double x) {
+	sinhcoshm1 r;
+	double h = copysign(0.5, x), ax = fabs(x);
+
+	if (isnan(x)) {
+		r.sinh = r.cosh = r.coshm1 = x;
+		return r;
+	}
+	if (ax < 22) {
+		double t = exexm1(ax).expm1;
+		if (ax < 1) {
+			double w = x * x;
+			r.sinh = h * (2*t - t*t/(t + 1));
+			r.coshm1 = 0.5*w + w*w*((((((((hc[0]*w + hc[1])*w + hc[2])*w + hc[3])*w + hc[4])*w + hc[5])*w + hc[6])*w + hc[7])*w + hc[8]);
+		} else {
+			r.sinh = h * (t + t/(t + 1));
+			r.coshm1 = 0.5 * (t - t/(t + 1));
+		}
+		r.cosh = 1 + r.coshm1;
+		return r;
+	}
+	if (ax < 709) {
+		double e = exexm1(ax).exp;
+		r.sinh = h * e;
+		r.cosh = 0.5 * e;
+		r.coshm1 = r.cosh - 1;
+		return r;
+	}
+	/* e^|x|/2 = (e^(|x|/2)/2) e^(|x|/2), which overflows just when
+	 * the result does. */
+	double w = exexm1(0.5 * ax).exp;
+	r.cosh = r.coshm1 = (0.5 * w) * w;
+	r.sinh = copysign(r.cosh, x);
+	return r;
+}
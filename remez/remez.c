@@ -0,0 +1,119 @@
+// Copyright © 2020 Neven Sajko. All rights reserved.
+
+// Refits the polynomials of sncs1cs (see kernels/sncs1cs.c) for a given
+// degree and interval of the reduced argument, and prints the result
+// as a coefficient table that can be pasted in place of sc[] or cc[].
+//
+// Usage:
+//
+//    remez sin|omc degree [a b]
+//
+// sin selects the sc[] polynomial, omc the cc[] one. The polynomials
+// are in w = z*z, for the reduced argument z in [a, b], which defaults
+// to [0, pi/4]. The degree counts the leading coefficient too, so the
+// existing six-element tables have degree 5; sncs1cs evaluates the
+// tables whole, so one of another degree can be pasted in too.
+//
+// The fit itself (a minimax fit in terms of relative error, with the
+// Remez exchange algorithm) is done by cnf_remez from the CNF FriCAS
+// package. The coefficients are rounded to double by FriCAS, the
+// printed maximum relative error is from before that rounding.
+//
+// The FriCAS computer algebra system is used. (Ensure 'fricas' is in
+// PATH.)
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <cfricas.h>
+
+#define nil 0
+
+#define FLTFMT "%27.20e"
+
+typedef struct {
+	// Name on the command line and in cnf_remez.
+	const char *name;
+
+	// Name of the coefficient table in sncs1cs.
+	const char *table;
+} kernel;
+
+static const kernel kernels[] = {
+	{"sin", "sc"},
+	{"omc", "cc"},
+};
+
+static
+void
+usage(void) {
+	fprintf(stderr, "usage: remez sin|omc degree [a b]\n");
+	exit(2);
+}
+
+int
+main(int argc, char *argv[]) {
+	if (argc != 3 && argc != 5) {
+		usage();
+	}
+	const kernel *k = nil;
+	int i;
+	for (i = 0; i < (int)(sizeof(kernels) / sizeof(kernels[0])); i++) {
+		if (strcmp(argv[1], kernels[i].name) == 0) {
+			k = &kernels[i];
+		}
+	}
+	char *end;
+	long degree = strtol(argv[2], &end, 10);
+	if (k == nil || *end != '\0' || degree < 0 || 30 < degree) {
+		usage();
+	}
+	double a = 0, b = 0.785398163397448309616;
+	if (argc == 5) {
+		a = strtod(argv[3], &end);
+		if (*end != '\0' || a < 0) {
+			usage();
+		}
+		b = strtod(argv[4], &end);
+		if (*end != '\0' || b <= a) {
+			usage();
+		}
+	}
+
+	FloatFricas fr = FricasFloatNew();
+	if (fr.in == nil || fr.out == nil) {
+		fprintf(stderr, "remez: failed to use fricas\n");
+		return 1;
+	}
+
+	// The polynomials are in the square of the reduced argument.
+	char cmd[200];
+	sprintf(cmd, "cnf_remez(\"%s\", %ld, " FLTFMT ", " FLTFMT ")$CNF\n", k->name, degree, a*a, b*b);
+	double err = FricasEval(fr, cmd);
+	if (isnan(err)) {
+		fprintf(stderr, "remez: the fit failed\n");
+		return 1;
+	}
+
+	printf("/* %s: degree %ld minimax fit on z in [%.20e, %.20e],\n", k->name, degree, a, b);
+	printf(" * max relative error %.3e before rounding to double. */\n", err);
+	printf("static const double %s[] = {\n", k->table);
+	long j;
+	for (j = degree; 0 <= j; j--) {
+		sprintf(cmd, "cnf_remezCoefficient(%ld)$CNF\n", j);
+		double c = FricasEval(fr, cmd);
+		if (isnan(c)) {
+			fprintf(stderr, "remez: failed to get coefficient %ld\n", j);
+			return 1;
+		}
+		printf("\t%.20E,\n", c);
+	}
+	printf("};\n");
+
+	if (FricasClose(fr)) {
+		fprintf(stderr, "remez: failed to close fricas pipes\n");
+	}
+	return 0;
+}
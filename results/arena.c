@@ -0,0 +1,141 @@
+// Arenas, see results.h.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#include "results.h"
+
+#define nil 0
+
+enum {
+	// Chunks are mapped in multiples of this, a huge page on x86-64.
+	ChunkBytes = 2 << 20,
+
+	// Alignment of the allocations, enough for any value kind.
+	Align = 16,
+};
+
+typedef struct chunk chunk;
+
+struct chunk {
+	chunk *next;
+	size_t size;
+};
+
+struct ResArena {
+	int huge;
+
+	// The chunks, the current one first, and the free part of the
+	// current one: [pos, end).
+	chunk *chunks;
+	unsigned char *pos, *end;
+
+	// The last allocation, which can grow in place.
+	unsigned char *last;
+
+	ResArenaStats st;
+};
+
+// Opens an empty arena; with huge, its chunks are advised to be backed
+// by transparent huge pages. Returns nil on failure.
+ResArena *
+resArenaOpen(int huge) {
+	ResArena *a = calloc(1, sizeof(*a));
+	if (a != nil) {
+		a->huge = huge;
+	}
+	return a;
+}
+
+static
+size_t
+roundUp(size_t n, size_t m) {
+	return (n + m - 1) / m * m;
+}
+
+// Maps a chunk with room for n bytes, and makes it current.
+static
+int
+newChunk(ResArena *a, size_t n) {
+	size_t size = roundUp(n + roundUp(sizeof(chunk), Align), ChunkBytes);
+	void *p = mmap(nil, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (p == MAP_FAILED) {
+		return -1;
+	}
+#ifdef MADV_HUGEPAGE
+	if (a->huge && madvise(p, size, MADV_HUGEPAGE) == 0) {
+		a->st.hugeChunks++;
+	}
+#endif
+	chunk *c = p;
+	c->next = a->chunks;
+	c->size = size;
+	a->chunks = c;
+	a->pos = (unsigned char *)p + roundUp(sizeof(chunk), Align);
+	a->end = (unsigned char *)p + size;
+	a->st.chunks++;
+	a->st.mappedBytes += size;
+	return 0;
+}
+
+// Returns n zeroed bytes, aligned for any value, or nil when out of
+// memory. They stay until the arena is closed.
+void *
+resArenaAlloc(ResArena *a, size_t n) {
+	n = roundUp(n == 0 ? 1 : n, Align);
+	if ((size_t)(a->end - a->pos) < n && newChunk(a, n)) {
+		return nil;
+	}
+	a->last = a->pos;
+	a->pos += n;
+	a->st.allocs++;
+	a->st.bytes += n;
+	return a->last;
+}
+
+// Grows the allocation p of n bytes to m bytes, zeroing the new ones:
+// in place if it is the last allocation and the chunk has room, or
+// else into a new allocation, leaving the old one unused. Returns nil
+// when out of memory, with p unchanged.
+void *
+resArenaGrow(ResArena *a, void *p, size_t n, size_t m) {
+	if (p == nil) {
+		return resArenaAlloc(a, m);
+	}
+	n = roundUp(n == 0 ? 1 : n, Align);
+	m = roundUp(m, Align);
+	if (m <= n) {
+		return p;
+	}
+	if (p == a->last && m - n <= (size_t)(a->end - a->pos)) {
+		a->pos += m - n;
+		a->st.bytes += m - n;
+		a->st.grownInPlace++;
+		return p;
+	}
+	void *q = resArenaAlloc(a, m);
+	if (q != nil) {
+		memcpy(q, p, n);
+		a->st.copiedBytes += n;
+	}
+	return q;
+}
+
+void
+resArenaStats(const ResArena *a, ResArenaStats *st) {
+	*st = a->st;
+}
+
+// Releases all of the memory of the arena at once, and a itself.
+void
+resArenaClose(ResArena *a) {
+	while (a->chunks != nil) {
+		chunk *c = a->chunks;
+		a->chunks = c->next;
+		munmap(c, c->size);
+	}
+	free(a);
+}
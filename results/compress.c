@@ -0,0 +1,297 @@
+// Writing and reading of the compressed form, see results.h. Link with
+// -lz.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zlib.h>
+
+#include "results.h"
+
+#define nil 0
+
+enum {
+	// zlib level: the data is repetitive enough that the fastest
+	// level gets most of the gain.
+	Level = 1,
+
+	// Room for the compressor's output, and for its input when
+	// reading.
+	ChunkBytes = 256 << 10,
+};
+
+struct ResZWriter {
+	FILE *f;
+	ResHeader h;
+	z_stream z;
+
+	// The last point's x and the last range's upper limit, the bases
+	// of the deltas.
+	unsigned char x[ResSlotBytes], limit[ResSlotBytes];
+
+	// The records, compressed when buf is full, and the compressor's
+	// output.
+	unsigned char *buf, *chunk;
+	size_t n;
+};
+
+struct ResZReader {
+	FILE *f;
+	ResHeader h;
+	z_stream z;
+	unsigned char x[ResSlotBytes], limit[ResSlotBytes];
+
+	// The decompressed bytes [pos, n) of out are not read yet.
+	unsigned char *in, *out;
+	size_t pos, n;
+	int end;
+};
+
+// The slot operations: the values are taken as two 64 bit words, in
+// the byte order of the machine, so that consecutive inputs differ in
+// the low word of the significand only.
+static
+void
+slotSub(unsigned char *a, const unsigned char *b) {
+	int i;
+	for (i = 0; i < ResSlotBytes; i += 8) {
+		uint64_t u, v;
+		memcpy(&u, &a[i], 8);
+		memcpy(&v, &b[i], 8);
+		u -= v;
+		memcpy(&a[i], &u, 8);
+	}
+}
+
+static
+void
+slotAdd(unsigned char *a, const unsigned char *b) {
+	int i;
+	for (i = 0; i < ResSlotBytes; i += 8) {
+		uint64_t u, v;
+		memcpy(&u, &a[i], 8);
+		memcpy(&v, &b[i], 8);
+		u += v;
+		memcpy(&a[i], &u, 8);
+	}
+}
+
+static
+void
+slotXor(unsigned char *a, const unsigned char *b) {
+	int i;
+	for (i = 0; i < ResSlotBytes; i++) {
+		a[i] ^= b[i];
+	}
+}
+
+// Replaces the inputs of r with their deltas, and the new and accurate
+// values with their xor with the old value.
+static
+void
+transform(unsigned char *x, unsigned char *limit, ResRecord *r) {
+	unsigned char t[ResSlotBytes];
+	switch (r->tag) {
+	case ResPoint:
+		memcpy(t, r->v[ResX], ResSlotBytes);
+		slotSub(r->v[ResX], x);
+		memcpy(x, t, ResSlotBytes);
+		slotXor(r->v[ResNew], r->v[ResOld]);
+		slotXor(r->v[ResAccurate], r->v[ResOld]);
+		break;
+	case ResRange:
+		memcpy(t, r->v[ResLimit1], ResSlotBytes);
+		slotSub(r->v[ResLimit1], r->v[ResLimit0]);
+		slotSub(r->v[ResLimit0], limit);
+		memcpy(limit, t, ResSlotBytes);
+		break;
+	}
+}
+
+static
+void
+untransform(unsigned char *x, unsigned char *limit, ResRecord *r) {
+	switch (r->tag) {
+	case ResPoint:
+		slotAdd(r->v[ResX], x);
+		memcpy(x, r->v[ResX], ResSlotBytes);
+		slotXor(r->v[ResNew], r->v[ResOld]);
+		slotXor(r->v[ResAccurate], r->v[ResOld]);
+		break;
+	case ResRange:
+		slotAdd(r->v[ResLimit0], limit);
+		slotAdd(r->v[ResLimit1], r->v[ResLimit0]);
+		memcpy(limit, r->v[ResLimit1], ResSlotBytes);
+		break;
+	}
+}
+
+// Compresses n bytes at p, and writes the output. Returns 0 on success.
+static
+int
+deflateOut(ResZWriter *w, const unsigned char *p, size_t n, int flush) {
+	w->z.next_in = (unsigned char *)p;
+	w->z.avail_in = (uInt)n;
+	do {
+		w->z.next_out = w->chunk;
+		w->z.avail_out = ChunkBytes;
+		int e = deflate(&w->z, flush);
+		if (e == Z_STREAM_ERROR) {
+			return -1;
+		}
+		size_t m = ChunkBytes - w->z.avail_out;
+		if (fwrite(w->chunk, 1, m, w->f) != m) {
+			return -1;
+		}
+	} while (w->z.avail_out == 0);
+	return 0;
+}
+
+// Starts a compressed stream with the header h on f. Returns nil on
+// failure.
+ResZWriter *
+resZWriterOpen(FILE *f, const ResHeader *h) {
+	ResZWriter *w = calloc(1, sizeof(*w));
+	if (w == nil) {
+		return nil;
+	}
+	w->f = f;
+	w->h = *h;
+	w->buf = malloc(ResBufferBytes);
+	w->chunk = malloc(ChunkBytes);
+	if (w->buf == nil || w->chunk == nil || deflateInit(&w->z, Level) != Z_OK) {
+		goto fail;
+	}
+	if (fwrite(ResZMagic, 8, 1, f) != 1 || deflateOut(w, (const unsigned char *)h, sizeof(*h), Z_NO_FLUSH)) {
+		deflateEnd(&w->z);
+		goto fail;
+	}
+	return w;
+fail:
+	free(w->buf);
+	free(w->chunk);
+	free(w);
+	return nil;
+}
+
+// Returns 0 on success.
+int
+resZWrite(ResZWriter *w, const ResRecord *r) {
+	ResRecord t = *r;
+	transform(w->x, w->limit, &t);
+	w->n += resEncode(&w->h, &t, &w->buf[w->n]);
+	if (ResBufferBytes - ResMaxRecordBytes < w->n) {
+		int e = deflateOut(w, w->buf, w->n, Z_NO_FLUSH);
+		w->n = 0;
+		return e;
+	}
+	return 0;
+}
+
+// Ends the stream and frees w. Returns 0 if everything was written.
+int
+resZWriterClose(ResZWriter *w) {
+	int e = deflateOut(w, w->buf, w->n, Z_FINISH) || fflush(w->f);
+	deflateEnd(&w->z);
+	free(w->buf);
+	free(w->chunk);
+	free(w);
+	return e;
+}
+
+// Makes at least m decompressed bytes available, unless the stream ends
+// first. Returns -1 for a corrupt stream.
+static
+int
+fill(ResZReader *r, size_t m) {
+	if (r->n - r->pos < m) {
+		memmove(r->out, &r->out[r->pos], r->n - r->pos);
+		r->n -= r->pos;
+		r->pos = 0;
+	}
+	while (r->n < m && !r->end) {
+		if (r->z.avail_in == 0) {
+			r->z.next_in = r->in;
+			r->z.avail_in = (uInt)fread(r->in, 1, ChunkBytes, r->f);
+			if (r->z.avail_in == 0) {
+				return -1;
+			}
+		}
+		r->z.next_out = &r->out[r->n];
+		r->z.avail_out = (uInt)(ResBufferBytes - r->n);
+		int e = inflate(&r->z, Z_NO_FLUSH);
+		if (e != Z_OK && e != Z_STREAM_END) {
+			return -1;
+		}
+		r->n = ResBufferBytes - r->z.avail_out;
+		r->end = e == Z_STREAM_END;
+	}
+	return 0;
+}
+
+// Starts reading a compressed stream from f. Returns nil if it does not
+// start with a valid header in the byte order of this machine.
+ResZReader *
+resZReaderOpen(FILE *f) {
+	char magic[8];
+	if (fread(magic, 8, 1, f) != 1 || memcmp(magic, ResZMagic, 8) != 0) {
+		return nil;
+	}
+	ResZReader *r = calloc(1, sizeof(*r));
+	if (r == nil) {
+		return nil;
+	}
+	r->f = f;
+	r->in = malloc(ChunkBytes);
+	r->out = malloc(ResBufferBytes);
+	if (r->in == nil || r->out == nil || inflateInit(&r->z) != Z_OK) {
+		free(r->in);
+		free(r->out);
+		free(r);
+		return nil;
+	}
+	if (fill(r, sizeof(r->h)) || r->n < sizeof(r->h)) {
+		resZReaderClose(r);
+		return nil;
+	}
+	memcpy(&r->h, r->out, sizeof(r->h));
+	r->pos = sizeof(r->h);
+	if (resCheckHeader(&r->h)) {
+		resZReaderClose(r);
+		return nil;
+	}
+	return r;
+}
+
+const ResHeader *
+resZHeader(const ResZReader *r) {
+	return &r->h;
+}
+
+// Reads the next record into rec. Returns 1 for a record, 0 at the end
+// of the stream, and -1 for an invalid or truncated record.
+int
+resZRead(ResZReader *r, ResRecord *rec) {
+	if (fill(r, ResMaxRecordBytes)) {
+		return -1;
+	}
+	if (r->pos == r->n) {
+		return 0;
+	}
+	size_t m = resDecode(&r->h, &r->out[r->pos], r->n - r->pos, rec);
+	if (m == 0) {
+		return -1;
+	}
+	r->pos += m;
+	untransform(r->x, r->limit, rec);
+	return 1;
+}
+
+void
+resZReaderClose(ResZReader *r) {
+	inflateEnd(&r->z);
+	free(r->in);
+	free(r->out);
+	free(r);
+}
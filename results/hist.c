@@ -0,0 +1,26 @@
+// The histograms, see results.h.
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "results.h"
+
+// The bucket of an error of ulps.
+int
+resHistBucket(uint64_t ulps) {
+	if (ulps == 0) {
+		return 0;
+	}
+	int b = 64 - __builtin_clzll(ulps);
+	return b < ResHistBuckets ? b : ResHistBuckets - 1;
+}
+
+// Adds the counts of b to a, of the same function, values and binade.
+void
+resHistMerge(ResRecord *a, const ResRecord *b) {
+	int i;
+	a->total += b->total;
+	for (i = 0; i < ResHistBuckets; i++) {
+		a->counts[i] += b->counts[i];
+	}
+}
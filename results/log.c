@@ -0,0 +1,169 @@
+// Logs of records drained by a writer thread, see results.h. Link with
+// -pthread.
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "results.h"
+
+#define nil 0
+
+enum {
+	// Records are handed to the writer thread a block at a time.
+	BlockBytes = 256 << 10,
+};
+
+typedef struct block block;
+
+struct block {
+	block *next;
+	size_t n;
+	unsigned char p[BlockBytes];
+};
+
+struct ResLog {
+	ResHeader h;
+	ResSink sink;
+	void *arg;
+
+	// The block being filled, owned by the caller.
+	block *cur;
+
+	// The full blocks, from head to tail, and the drained ones, for
+	// reuse. Guarded by mu.
+	block *head, *tail, *free;
+	int done, err;
+
+	pthread_t thread;
+	pthread_mutex_t mu;
+	pthread_cond_t cond;
+};
+
+static
+void *
+drain(void *arg) {
+	ResLog *l = arg;
+	pthread_mutex_lock(&l->mu);
+	for (;;) {
+		while (l->head == nil && !l->done) {
+			pthread_cond_wait(&l->cond, &l->mu);
+		}
+		block *b = l->head;
+		if (b == nil) {
+			break;
+		}
+		l->head = b->next;
+		if (l->head == nil) {
+			l->tail = nil;
+		}
+		int err = l->err;
+		pthread_mutex_unlock(&l->mu);
+
+		size_t i, m;
+		ResRecord r;
+		for (i = 0; !err && i < b->n; i += m) {
+			m = resDecode(&l->h, &b->p[i], b->n - i, &r);
+			err = m == 0 ? -1 : l->sink(l->arg, &r);
+		}
+
+		pthread_mutex_lock(&l->mu);
+		l->err = err;
+		b->next = l->free;
+		l->free = b;
+	}
+	pthread_mutex_unlock(&l->mu);
+	return nil;
+}
+
+// Queues the block being filled, under mu.
+static
+void
+queue(ResLog *l) {
+	l->cur->next = nil;
+	if (l->tail == nil) {
+		l->head = l->cur;
+	} else {
+		l->tail->next = l->cur;
+	}
+	l->tail = l->cur;
+	pthread_cond_signal(&l->cond);
+}
+
+// Queues the block being filled, and takes a drained one, or a new one.
+static
+int
+publish(ResLog *l) {
+	pthread_mutex_lock(&l->mu);
+	block *b = l->free;
+	if (b != nil) {
+		l->free = b->next;
+	}
+	pthread_mutex_unlock(&l->mu);
+	if (b == nil && (b = malloc(sizeof(*b))) == nil) {
+		return -1;
+	}
+	b->n = 0;
+	pthread_mutex_lock(&l->mu);
+	queue(l);
+	int err = l->err;
+	pthread_mutex_unlock(&l->mu);
+	l->cur = b;
+	return err;
+}
+
+// Starts a log of records with the header h, and its writer thread,
+// which passes each record to sink, with arg. Returns nil on failure.
+ResLog *
+resLogOpen(const ResHeader *h, ResSink sink, void *arg) {
+	ResLog *l = calloc(1, sizeof(*l));
+	if (l == nil || (l->cur = malloc(sizeof(*l->cur))) == nil) {
+		free(l);
+		return nil;
+	}
+	l->h = *h;
+	l->sink = sink;
+	l->arg = arg;
+	l->cur->n = 0;
+	pthread_mutex_init(&l->mu, nil);
+	pthread_cond_init(&l->cond, nil);
+	if (pthread_create(&l->thread, nil, drain, l) != 0) {
+		free(l->cur);
+		free(l);
+		return nil;
+	}
+	return l;
+}
+
+// Appends r to the log. It never waits for the sink. Returns 0 on
+// success; a failure of the sink shows up in a later call.
+int
+resLog(ResLog *l, const ResRecord *r) {
+	l->cur->n += resEncode(&l->h, r, &l->cur->p[l->cur->n]);
+	if (BlockBytes - ResMaxRecordBytes < l->cur->n) {
+		return publish(l);
+	}
+	return 0;
+}
+
+// Drains the log, waits for the writer thread and frees l. Returns 0 if
+// the sink took every record.
+int
+resLogClose(ResLog *l) {
+	pthread_mutex_lock(&l->mu);
+	queue(l);
+	l->done = 1;
+	pthread_mutex_unlock(&l->mu);
+	pthread_join(l->thread, nil);
+	int err = l->err;
+	while (l->free != nil) {
+		block *b = l->free;
+		l->free = b->next;
+		free(b);
+	}
+	pthread_mutex_destroy(&l->mu);
+	pthread_cond_destroy(&l->cond);
+	free(l);
+	return err;
+}
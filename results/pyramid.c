@@ -0,0 +1,124 @@
+// Merging of ranges and nodes of the pyramid, see results.h.
+
+#define __STDC_WANT_IEC_60559_TYPES_EXT__
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "results.h"
+
+// The value in slot, in long double, which is enough for statistics.
+static
+long double
+get(const ResHeader *h, const unsigned char *slot) {
+	switch (h->valueKind) {
+	case ResValueDouble: {
+		double x;
+		memcpy(&x, slot, sizeof(x));
+		return x;
+	}
+	case ResValueLdbl: {
+		long double x = 0;
+		memcpy(&x, slot, 10);
+		return x;
+	}
+	default: {
+#ifdef __FLT128_MANT_DIG__
+		_Float128 x;
+		memcpy(&x, slot, sizeof(x));
+		return (long double)x;
+#else
+		return NAN;
+#endif
+	}
+	}
+}
+
+static
+void
+set(const ResHeader *h, unsigned char *slot, long double v) {
+	switch (h->valueKind) {
+	case ResValueDouble: {
+		double x = (double)v;
+		resSetValue(h, slot, &x);
+		break;
+	}
+	case ResValueLdbl:
+		resSetValue(h, slot, &v);
+		break;
+	default: {
+#ifdef __FLT128_MANT_DIG__
+		_Float128 x = (_Float128)v;
+		resSetValue(h, slot, &x);
+#endif
+		break;
+	}
+	}
+}
+
+// Merges the quadratic means m of a count of c scores each; a mean of
+// no scores is NaN, as the checker gives it.
+static
+long double
+mean2(long double m0, long double c0, long double m1, long double c1) {
+	long double s = 0;
+	if (c0 != 0) {
+		s += m0*m0*c0;
+	}
+	if (c1 != 0) {
+		s += m1*m1*c1;
+	}
+	return sqrtl(s/(c0 + c1));
+}
+
+// Merges b into a, both ranges or nodes of the pyramid of a function:
+// a gets the statistics of the points of both, and the least and the
+// greatest of their limits, which are in no particular order.
+void
+resRangeMerge(const ResHeader *h, ResRecord *a, const ResRecord *b) {
+	int i;
+	long double n0 = 0, n1 = 0;
+	for (i = 0; i < 2; i++) {
+		int mx = ResImprovMaxScor + 2*i, m2 = ResImprovMean2 + 2*i;
+		long double c0 = a->count[i], c1 = b->count[i];
+		n0 += c0;
+		n1 += c1;
+		if (c1 == 0) {
+			continue;
+		}
+		if (c0 == 0 || fabsl(get(h, a->v[mx])) < fabsl(get(h, b->v[mx]))) {
+			memcpy(a->v[mx], b->v[mx], ResSlotBytes);
+		}
+		// The largest improvement, or the largest worsening, which is
+		// the most negative.
+		if (c0 == 0 || (i == 0 ? a->max[i] < b->max[i] : b->max[i] < a->max[i])) {
+			a->max[i] = b->max[i];
+		}
+		set(h, a->v[m2], mean2(get(h, a->v[m2]), c0, get(h, b->v[m2]), c1));
+		a->count[i] += b->count[i];
+	}
+	if (n1 != 0) {
+		long double s = get(h, b->v[ResMean1])*n1;
+		if (n0 != 0) {
+			s += get(h, a->v[ResMean1])*n0;
+		}
+		set(h, a->v[ResMean1], s/(n0 + n1));
+	}
+	if (get(h, a->v[ResLimit1]) < get(h, a->v[ResLimit0])) {
+		unsigned char t[ResSlotBytes];
+		memcpy(t, a->v[ResLimit0], ResSlotBytes);
+		memcpy(a->v[ResLimit0], a->v[ResLimit1], ResSlotBytes);
+		memcpy(a->v[ResLimit1], t, ResSlotBytes);
+	}
+	for (i = ResLimit0; i <= ResLimit1; i++) {
+		long double y = get(h, b->v[i]);
+		if (y < get(h, a->v[ResLimit0])) {
+			memcpy(a->v[ResLimit0], b->v[i], ResSlotBytes);
+		}
+		if (get(h, a->v[ResLimit1]) < y) {
+			memcpy(a->v[ResLimit1], b->v[i], ResSlotBytes);
+		}
+	}
+}
@@ -0,0 +1,466 @@
+// Copyright © 2020 Neven Sajko. All rights reserved.
+
+// Compares two reports of the checker, e.g. the results for two libms,
+// in one pass over both, and prints the points, ranges and misrounded
+// counts that differ, and a summary for each function.
+//
+// Usage:
+//
+//    resdiff [-b] a b
+//
+// Each report is in the text form or in the binary form (see
+// results.h); the binary form is mapped into memory when it is in a
+// regular file. A file named - is the standard input.
+//
+// Both reports must come from the same kind of sweep, so that their
+// points are in the same order: increasing x, or with -b, the order of
+// the bit patterns of x, which is that of the exhaustive sweeps of the
+// narrow formats.
+//
+// The output is like a diff without context: the lines of the text
+// form that only a has, or that differ, prefixed with "- ", and those
+// of b, with "+ ". Differing ranges follow a "@@ ranges of" line with
+// the function. In the summary, each function gets the numbers of
+// points of each classification, of ranges, and the sums over the
+// ranges of the counts of improvements and worsenings, for a, each
+// followed by the change in b. Also the numbers of points and ranges
+// that only one report has, and of those that both have, but with
+// another classification (reclassified) or other values (changed).
+// The top lists, the histograms, the pyramid and the samples, which
+// follow from the points, are not compared.
+//
+// The exit status is 0 if the reports are the same, 1 if they differ,
+// and 2 on trouble.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "results.h"
+
+#define nil 0
+
+enum {
+	// Most points with the same x from one report that are compared
+	// at a time.
+	MaxGroup = 2*ResMaxFuncs,
+
+	MaxStats = 2*ResMaxFuncs,
+};
+
+typedef struct {
+	const char *name;
+	int text;
+
+	FILE *f;
+	ResTextReader tr;
+
+	// The binary form: its header, and, if it is mapped, the mapping
+	// and the offset of the next record.
+	ResHeader h;
+	const unsigned char *p;
+	size_t size, off;
+
+	// The next record, if have is set, and the order key of the last
+	// point.
+	ResRecord r;
+	int have, last;
+	ResKey lastKey;
+} source;
+
+typedef struct {
+	char name[4];
+
+	// Per report: points of each classification, ranges, the sums of
+	// improvements and worsenings in ranges, and misrounded results.
+	long points[2][ResWrong + 1], ranges[2], improv[2], worse[2], misrounded[2];
+	int hasMisrounded;
+
+	long pointsOnly[2], reclassified, changed, rangesOnly[2], rangesChanged;
+} funcStats;
+
+static funcStats stats[MaxStats];
+static int nStats, bitOrder, differ;
+
+static
+void
+fail(const char *msg, const source *s) {
+	if (s != nil && s->text && s->tr.line != 0) {
+		fprintf(stderr, "resdiff: %s: line %ld: %s\n", s->name, s->tr.line, msg);
+	} else if (s != nil) {
+		fprintf(stderr, "resdiff: %s: %s\n", s->name, msg);
+	} else {
+		fprintf(stderr, "resdiff: %s\n", msg);
+	}
+	exit(2);
+}
+
+static
+const ResHeader *
+header(const source *s) {
+	return s->text ? &s->tr.h : &s->h;
+}
+
+// The position of the function among those of the range section.
+static
+int
+position(const source *s, int fn) {
+	return s->text ? s->tr.pos[fn] : fn;
+}
+
+static
+const char *
+funcName(const source *s, int fn) {
+	return header(s)->funcNames[fn];
+}
+
+static
+funcStats *
+statsOf(const char *name) {
+	int i;
+	for (i = 0; i < nStats; i++) {
+		if (strcmp(stats[i].name, name) == 0) {
+			return &stats[i];
+		}
+	}
+	if (nStats == MaxStats) {
+		fail("too many functions", nil);
+	}
+	strcpy(stats[nStats].name, name);
+	return &stats[nStats++];
+}
+
+// The key that orders the records of the sweep: by value, or with -b,
+// by bit pattern.
+static
+ResKey
+orderKey(const source *s, const unsigned char *slot) {
+	ResKey k = resKey(header(s), slot);
+	if (bitOrder) {
+		if (k.hi >> 63) {
+			k.hi &= ~((uint64_t)1 << 63);
+		} else {
+			k.hi = ~k.hi;
+			k.lo = ~k.lo;
+		}
+	}
+	return k;
+}
+
+static
+void
+advance(source *s) {
+	int e;
+	if (s->text) {
+		e = resReadText(&s->tr, &s->r);
+	} else if (s->p != nil) {
+		size_t n = 0;
+		e = s->off != s->size;
+		if (e) {
+			n = resDecode(&s->h, &s->p[s->off], s->size - s->off, &s->r);
+			e = n == 0 ? -1 : 1;
+		}
+		s->off += n;
+	} else {
+		e = resRead(s->f, &s->h, &s->r);
+	}
+	if (e < 0) {
+		fail("invalid or truncated record", s);
+	}
+	s->have = e;
+	if (s->have && s->r.tag == ResPoint) {
+		ResKey k = orderKey(s, s->r.v[ResX]);
+		if (s->last && resKeyCmp(k, s->lastKey) < 0) {
+			fail(bitOrder ? "points not in the order of bit patterns" :
+				"points not in increasing order (try -b for the narrow sweeps)", s);
+		}
+		s->last = 1;
+		s->lastKey = k;
+	}
+}
+
+static
+void
+openSource(source *s, const char *name) {
+	memset(s, 0, sizeof(*s));
+	s->name = name;
+	s->f = strcmp(name, "-") == 0 ? stdin : fopen(name, "rb");
+	if (s->f == nil) {
+		fail("cannot open", s);
+	}
+	int c = getc(s->f);
+	if (c != EOF) {
+		ungetc(c, s->f);
+	}
+	if (c != ResMagic[0]) {
+		s->text = 1;
+		resTextReaderInit(&s->tr, s->f);
+	} else {
+		struct stat st;
+		void *p = MAP_FAILED;
+		if (fstat(fileno(s->f), &st) == 0 && S_ISREG(st.st_mode) && sizeof(s->h) <= (uint64_t)st.st_size) {
+			p = mmap(nil, (size_t)st.st_size, PROT_READ, MAP_SHARED, fileno(s->f), 0);
+		}
+		if (p != MAP_FAILED) {
+			s->p = p;
+			s->size = (size_t)st.st_size;
+			s->off = sizeof(s->h);
+			memcpy(&s->h, s->p, sizeof(s->h));
+			if (resCheckHeader(&s->h)) {
+				fail("not a report, or from a machine with another byte order", s);
+			}
+		} else {
+			setvbuf(s->f, nil, _IOFBF, ResBufferBytes);
+			if (resReadHeader(s->f, &s->h)) {
+				fail("not a report, or from a machine with another byte order", s);
+			}
+		}
+	}
+	advance(s);
+}
+
+// Prints the text form of r, each line prefixed.
+static
+void
+show(const source *s, const ResRecord *r, const char *prefix) {
+	char buf[ResMaxTextBytes];
+	resFormat(header(s), r, buf);
+	char *line, *next;
+	for (line = buf; *line != '\0'; line = next) {
+		next = strchr(line, '\n');
+		*next++ = '\0';
+		if (*line != '\0') {
+			printf("%s%s\n", prefix, line);
+		}
+	}
+	differ = 1;
+}
+
+static
+void
+countPoint(const source *s, const ResRecord *r, int side) {
+	statsOf(funcName(s, r->fn))->points[side][r->status]++;
+}
+
+// Compares the points with the same x: a[0..na) and b[0..nb).
+static
+void
+comparePoints(const source *sa, ResRecord *a, int na, const source *sb, ResRecord *b, int nb) {
+	int matched[MaxGroup] = {0}, i, j;
+	for (i = 0; i < na; i++) {
+		const char *name = funcName(sa, a[i].fn);
+		funcStats *st = statsOf(name);
+		for (j = 0; j < nb && (matched[j] || strcmp(funcName(sb, b[j].fn), name) != 0); j++) {
+		}
+		if (j == nb) {
+			st->pointsOnly[0]++;
+			show(sa, &a[i], "- ");
+			continue;
+		}
+		matched[j] = 1;
+		char ta[ResMaxTextBytes], tb[ResMaxTextBytes];
+		resFormat(header(sa), &a[i], ta);
+		resFormat(header(sb), &b[j], tb);
+		if (a[i].status != b[j].status) {
+			st->reclassified++;
+		} else if (strcmp(ta, tb) != 0) {
+			st->changed++;
+		} else {
+			continue;
+		}
+		show(sa, &a[i], "- ");
+		show(sb, &b[j], "+ ");
+	}
+	for (j = 0; j < nb; j++) {
+		if (!matched[j]) {
+			statsOf(funcName(sb, b[j].fn))->pointsOnly[1]++;
+			show(sb, &b[j], "+ ");
+		}
+	}
+}
+
+// Collects the next points of s with the order key k.
+static
+int
+group(source *s, ResKey k, ResRecord *g, int side) {
+	int n = 0;
+	while (n < MaxGroup && s->have && s->r.tag == ResPoint && resKeyCmp(orderKey(s, s->r.v[ResX]), k) == 0) {
+		countPoint(s, &s->r, side);
+		g[n++] = s->r;
+		advance(s);
+	}
+	return n;
+}
+
+static
+void
+countRange(const source *s, const ResRecord *r, int side) {
+	funcStats *st = statsOf(funcName(s, r->fn));
+	st->ranges[side]++;
+	st->improv[side] += r->count[0];
+	st->worse[side] += r->count[1];
+}
+
+static
+void
+rangeHeading(const char *name) {
+	static char last[4];
+	if (strcmp(last, name) != 0) {
+		printf("@@ ranges of %s\n", name);
+		strcpy(last, name);
+	}
+}
+
+// Compares the order of the ranges at a and at b.
+static
+int
+rangeCmp(const source *a, const source *b) {
+	int pa = position(a, a->r.fn), pb = position(b, b->r.fn);
+	if (pa != pb) {
+		return pa < pb ? -1 : 1;
+	}
+	if (strcmp(funcName(a, a->r.fn), funcName(b, b->r.fn)) != 0) {
+		fail("the reports are for different functions", nil);
+	}
+	return resKeyCmp(orderKey(a, a->r.v[ResLimit0]), orderKey(b, b->r.v[ResLimit0]));
+}
+
+static
+void
+diffRanges(source *a, source *b) {
+	for (;;) {
+		int ra = a->have && a->r.tag == ResRange, rb = b->have && b->r.tag == ResRange;
+		if (!ra && !rb) {
+			return;
+		}
+		int c = !ra ? 1 : !rb ? -1 : rangeCmp(a, b);
+		if (c < 0) {
+			countRange(a, &a->r, 0);
+			statsOf(funcName(a, a->r.fn))->rangesOnly[0]++;
+			rangeHeading(funcName(a, a->r.fn));
+			show(a, &a->r, "- ");
+			advance(a);
+		} else if (0 < c) {
+			countRange(b, &b->r, 1);
+			statsOf(funcName(b, b->r.fn))->rangesOnly[1]++;
+			rangeHeading(funcName(b, b->r.fn));
+			show(b, &b->r, "+ ");
+			advance(b);
+		} else {
+			countRange(a, &a->r, 0);
+			countRange(b, &b->r, 1);
+			char ta[ResMaxTextBytes], tb[ResMaxTextBytes];
+			resFormat(header(a), &a->r, ta);
+			resFormat(header(b), &b->r, tb);
+			if (strcmp(ta, tb) != 0) {
+				statsOf(funcName(a, a->r.fn))->rangesChanged++;
+				rangeHeading(funcName(a, a->r.fn));
+				show(a, &a->r, "- ");
+				show(b, &b->r, "+ ");
+			}
+			advance(a);
+			advance(b);
+		}
+	}
+}
+
+static
+void
+diffMisrounded(source *s, int side) {
+	for (; s->have; advance(s)) {
+		if (s->r.tag == ResTop || s->r.tag == ResHist || s->r.tag == ResPyramid || s->r.tag == ResSample) {
+			continue;
+		}
+		if (s->r.tag != ResMisrounded) {
+			fail("records out of order", s);
+		}
+		funcStats *st = statsOf(funcName(s, s->r.fn));
+		st->misrounded[side] = s->r.misrounded;
+		st->hasMisrounded = 1;
+	}
+}
+
+int
+main(int argc, char *argv[]) {
+	int i = 1;
+	if (i < argc && strcmp(argv[i], "-b") == 0) {
+		bitOrder = 1;
+		i++;
+	}
+	if (argc - i != 2) {
+		fprintf(stderr, "usage: resdiff [-b] a b\n");
+		return 2;
+	}
+	source a, b;
+	openSource(&a, argv[i]);
+	openSource(&b, argv[i + 1]);
+	setvbuf(stdout, nil, _IOFBF, ResBufferBytes);
+
+	// The points, merged by x.
+	for (;;) {
+		int pa = a.have && a.r.tag == ResPoint, pb = b.have && b.r.tag == ResPoint;
+		if (!pa && !pb) {
+			break;
+		}
+		if (header(&a)->valueKind != header(&b)->valueKind) {
+			fail("the reports have values of different kinds", nil);
+		}
+		ResKey ka = pa ? orderKey(&a, a.r.v[ResX]) : (ResKey){0, 0};
+		ResKey kb = pb ? orderKey(&b, b.r.v[ResX]) : (ResKey){0, 0};
+		int c = !pa ? 1 : !pb ? -1 : resKeyCmp(ka, kb);
+		ResRecord ga[MaxGroup], gb[MaxGroup];
+		int na = c <= 0 ? group(&a, ka, ga, 0) : 0;
+		int nb = 0 <= c ? group(&b, kb, gb, 1) : 0;
+		comparePoints(&a, ga, na, &b, gb, nb);
+	}
+
+	diffRanges(&a, &b);
+	diffMisrounded(&a, 0);
+	diffMisrounded(&b, 1);
+	for (i = 0; i < nStats; i++) {
+		if (stats[i].hasMisrounded && stats[i].misrounded[0] != stats[i].misrounded[1]) {
+			printf("- %3s: %ld not correctly rounded\n+ %3s: %ld not correctly rounded\n",
+				stats[i].name, stats[i].misrounded[0], stats[i].name, stats[i].misrounded[1]);
+			differ = 1;
+		}
+	}
+
+	// The functions in the order of the range section of a.
+	int order[MaxStats], rank[MaxStats], j;
+	for (i = 0; i < nStats; i++) {
+		const ResHeader *h = header(&a);
+		for (j = 0; j < h->funcCount && strcmp(h->funcNames[j], stats[i].name) != 0; j++) {
+		}
+		rank[i] = j < h->funcCount && 0 <= position(&a, j) ? position(&a, j) : ResMaxFuncs + i;
+		for (j = i; 0 < j && rank[i] < rank[order[j - 1]]; j--) {
+			order[j] = order[j - 1];
+		}
+		order[j] = i;
+	}
+
+	printf("\nsummary (a: %s, b: %s):\n", argv[argc - 2], argv[argc - 1]);
+	for (i = 0; i < nStats; i++) {
+		const funcStats *st = &stats[order[i]];
+		printf("%3s: better %ld %+ld, worse %ld %+ld, wrong %ld %+ld; only in a %ld, only in b %ld, reclassified %ld, changed %ld\n",
+			st->name,
+			st->points[0][ResBetter], st->points[1][ResBetter] - st->points[0][ResBetter],
+			st->points[0][ResWorse], st->points[1][ResWorse] - st->points[0][ResWorse],
+			st->points[0][ResWrong], st->points[1][ResWrong] - st->points[0][ResWrong],
+			st->pointsOnly[0], st->pointsOnly[1], st->reclassified, st->changed);
+		printf("     ranges %ld %+ld, improvements %ld %+ld, worsenings %ld %+ld; only in a %ld, only in b %ld, changed %ld\n",
+			st->ranges[0], st->ranges[1] - st->ranges[0],
+			st->improv[0], st->improv[1] - st->improv[0],
+			st->worse[0], st->worse[1] - st->worse[0],
+			st->rangesOnly[0], st->rangesOnly[1], st->rangesChanged);
+		if (st->hasMisrounded) {
+			printf("     misrounded %ld %+ld\n", st->misrounded[0], st->misrounded[1] - st->misrounded[0]);
+		}
+	}
+	if (fflush(stdout)) {
+		fail("write error", nil);
+	}
+	return differ;
+}
@@ -0,0 +1,137 @@
+// Copyright © 2020 Neven Sajko. All rights reserved.
+
+// Merges the top sections and the histogram sections (see results.h)
+// of reports in the binary form, e.g. of the shards of a sweep, as
+// written by the checker when compiled with CHECK_BINARY and CHECK_TOP
+// or CHECK_HIST, and prints these sections of all of them in the text
+// form. The histograms of a binade are summed.
+//
+// Usage:
+//
+//    resmerge report...
+//
+// The reports must be of the same functions and kind of values.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "results.h"
+
+#define nil 0
+
+static const ResHeader *header;
+
+// The histograms of all reports, from the first one and appended, in
+// order when sorted.
+static ResRecord *hist;
+static size_t nhist, histCap;
+
+static
+int
+addHist(const ResRecord *r) {
+	if (nhist == histCap) {
+		size_t c = histCap == 0 ? 1024 : 2*histCap;
+		ResRecord *p = realloc(hist, c*sizeof(hist[0]));
+		if (p == nil) {
+			return -1;
+		}
+		hist = p;
+		histCap = c;
+	}
+	hist[nhist++] = *r;
+	return 0;
+}
+
+// By function, old or new values, and binade.
+static
+int
+cmpHist(const void *a, const void *b) {
+	const ResRecord *p = a, *q = b;
+	if (p->fn != q->fn) {
+		return p->fn < q->fn ? -1 : 1;
+	}
+	if (p->status != q->status) {
+		return p->status < q->status ? -1 : 1;
+	}
+	return resKeyCmp(resKey(header, p->v[0]), resKey(header, q->v[0]));
+}
+
+int
+main(int argc, char *argv[]) {
+	if (argc < 2) {
+		fprintf(stderr, "usage: resmerge report...\n");
+		return 2;
+	}
+	ResTopHeap *top = calloc(ResMaxFuncs*ResTopLists, sizeof(top[0]));
+	if (top == nil) {
+		fprintf(stderr, "resmerge: out of memory\n");
+		return 1;
+	}
+	ResHeader h0, h;
+	int i;
+	for (i = 1; i < argc; i++) {
+		FILE *f = fopen(argv[i], "rb");
+		if (f == nil) {
+			fprintf(stderr, "resmerge: cannot open %s\n", argv[i]);
+			return 1;
+		}
+		setvbuf(f, nil, _IOFBF, ResBufferBytes);
+		if (resReadHeader(f, &h)) {
+			fprintf(stderr, "resmerge: %s is not a report in the binary form, or is from a machine with another byte order\n", argv[i]);
+			return 1;
+		}
+		if (i == 1) {
+			h0 = h;
+		} else if (h.valueKind != h0.valueKind || h.funcCount != h0.funcCount ||
+			memcmp(h.funcNames, h0.funcNames, sizeof(h.funcNames)) != 0) {
+			fprintf(stderr, "resmerge: %s is of other functions or values than %s\n", argv[i], argv[1]);
+			return 1;
+		}
+		ResRecord r;
+		int e;
+		while ((e = resRead(f, &h, &r)) == 1) {
+			if (r.tag == ResTop) {
+				resTopAdd(&h, &top[r.fn*ResTopLists + r.status], &r);
+			} else if (r.tag == ResHist && addHist(&r)) {
+				fprintf(stderr, "resmerge: out of memory\n");
+				return 1;
+			}
+		}
+		if (e < 0) {
+			fprintf(stderr, "resmerge: %s: invalid or truncated record\n", argv[i]);
+			return 1;
+		}
+		fclose(f);
+	}
+
+	// Only the top and the histogram sections: the range section
+	// counts as printed.
+	ResText t;
+	resTextInit(&t, &h0);
+	t.ranges = 1;
+	t.fn = h0.funcCount;
+	setvbuf(stdout, nil, _IOFBF, ResBufferBytes);
+	for (i = 0; i < h0.funcCount*ResTopLists; i++) {
+		resTopSort(&top[i]);
+		int j;
+		for (j = 0; j < top[i].n; j++) {
+			resText(&t, stdout, &top[i].e[j].r);
+		}
+	}
+	header = &h0;
+	qsort(hist, nhist, sizeof(hist[0]), cmpHist);
+	size_t j, k;
+	for (j = 0; j < nhist; j = k) {
+		for (k = j + 1; k < nhist && cmpHist(&hist[j], &hist[k]) == 0; k++) {
+			resHistMerge(&hist[j], &hist[k]);
+		}
+		resText(&t, stdout, &hist[j]);
+	}
+	if (fflush(stdout)) {
+		fprintf(stderr, "resmerge: write error\n");
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,57 @@
+// Copyright © 2020 Neven Sajko. All rights reserved.
+
+// Renders a report in the binary form (see results.h), as written by
+// the checker when compiled with CHECK_BINARY, into the text form that
+// the checker writes otherwise.
+//
+// Usage:
+//
+//    resprint [file]
+//
+// Without a file, the standard input is read.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "results.h"
+
+#define nil 0
+
+int
+main(int argc, char *argv[]) {
+	if (2 < argc) {
+		fprintf(stderr, "usage: resprint [file]\n");
+		return 2;
+	}
+	FILE *in = stdin;
+	if (argc == 2 && (in = fopen(argv[1], "rb")) == nil) {
+		fprintf(stderr, "resprint: cannot open %s\n", argv[1]);
+		return 1;
+	}
+	setvbuf(in, nil, _IOFBF, ResBufferBytes);
+	setvbuf(stdout, nil, _IOFBF, ResBufferBytes);
+
+	ResHeader h;
+	if (resReadHeader(in, &h)) {
+		fprintf(stderr, "resprint: not a report in the binary form, or from a machine with another byte order\n");
+		return 1;
+	}
+	ResText t;
+	resTextInit(&t, &h);
+	ResRecord r;
+	int e;
+	while ((e = resRead(in, &h, &r)) == 1) {
+		resText(&t, stdout, &r);
+	}
+	if (e < 0) {
+		fprintf(stderr, "resprint: invalid or truncated record\n");
+		return 1;
+	}
+	resTextEnd(&t, stdout);
+	if (fflush(stdout)) {
+		fprintf(stderr, "resprint: write error\n");
+		return 1;
+	}
+	return 0;
+}
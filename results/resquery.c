@@ -0,0 +1,268 @@
+// Copyright © 2020 Neven Sajko. All rights reserved.
+
+// Queries a store (see results.h), as written by the checker when
+// compiled with CHECK_STORE, and prints the selected records in the
+// text form of the checker's report.
+//
+// Usage:
+//
+//    resquery [-n] [-m] [-f func]... [-c class]... [-x from to] store
+//
+// -f selects a function by its name in the report (e.g. omc), -c a
+// class: better, worse or wrong for the points, ranges, misrounded, top
+// for the top lists, hist for the histograms, level1 to level4 for
+// the levels of the pyramid, or samples for the estimates of the error
+// rates.
+// Without them, all functions or classes are selected. -x selects the
+// points with x in [from, to], and the ranges and the nodes of the
+// pyramid that overlap it. -n prints the number of selected records of
+// each function and class, instead of the records. -m merges the
+// selected ranges of each function, and its selected nodes of each
+// level, into one, with the statistics of all their points; with the
+// pyramid, a summary of a wide interval takes only a few records.
+//
+// Link with results/pyramid.c and -lm.
+//
+// The records are found with binary searches, so a query takes time
+// logarithmic in the size of the store, plus the time to print the
+// output. The points are printed in the order of x, the rest as in the
+// report. Without -f, -c or -x, the output is the whole report.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "results.h"
+
+#define nil 0
+
+static const char *const classNames[] = {"ranges", "better", "worse", "wrong", "misrounded", "top", "hist",
+	"level1", "level2", "level3", "level4", "samples"};
+
+static
+void
+usage(void) {
+	fprintf(stderr, "usage: resquery [-n] [-m] [-f func]... [-c class]... [-x from to] store\n");
+	exit(2);
+}
+
+// The key following k.
+static
+ResKey
+keySucc(ResKey k) {
+	k.lo++;
+	if (k.lo == 0) {
+		k.hi++;
+	}
+	return k;
+}
+
+typedef struct {
+	int fn, class;
+
+	// The selected records: [i, end).
+	uint64_t i, end;
+} cursor;
+
+// Whether the records of the class are ranges.
+static
+int
+isRanges(int class) {
+	return class == ResStoreRanges || ResStorePyramid <= class && class < ResStoreSample;
+}
+
+// Prints the selected records of the bucket of p, or with merge, the
+// selected ranges or nodes of the pyramid merged into one.
+static
+void
+printBucket(const ResStore *s, ResText *t, cursor *p, int merge) {
+	ResRecord r, m;
+	if (merge && isRanges(p->class)) {
+		if (p->i == p->end) {
+			return;
+		}
+		resStoreGet(s, p->fn, p->class, p->i++, &m);
+		for (; p->i < p->end; p->i++) {
+			resStoreGet(s, p->fn, p->class, p->i, &r);
+			resRangeMerge(&s->sh.h, &m, &r);
+		}
+		resText(t, stdout, &m);
+		return;
+	}
+	for (; p->i < p->end; p->i++) {
+		resStoreGet(s, p->fn, p->class, p->i, &r);
+		resText(t, stdout, &r);
+	}
+}
+
+int
+main(int argc, char *argv[]) {
+	int count = 0, merge = 0, fnSel = 0, classSel = 0, i;
+	const char *fnArgs[ResMaxFuncs], *from = nil, *to = nil;
+	int nFnArgs = 0;
+	for (i = 1; i < argc - 1; i++) {
+		if (strcmp(argv[i], "-n") == 0) {
+			count = 1;
+		} else if (strcmp(argv[i], "-m") == 0) {
+			merge = 1;
+		} else if (strcmp(argv[i], "-f") == 0 && i + 2 < argc && nFnArgs < ResMaxFuncs) {
+			fnArgs[nFnArgs++] = argv[++i];
+		} else if (strcmp(argv[i], "-c") == 0 && i + 2 < argc) {
+			int c;
+			for (c = 0; c < ResStoreClasses && strcmp(argv[i + 1], classNames[c]) != 0; c++) {
+			}
+			if (c == ResStoreClasses) {
+				usage();
+			}
+			classSel |= 1 << c;
+			i++;
+		} else if (strcmp(argv[i], "-x") == 0 && i + 3 < argc) {
+			from = argv[i + 1];
+			to = argv[i + 2];
+			i += 2;
+		} else {
+			usage();
+		}
+	}
+	if (i != argc - 1) {
+		usage();
+	}
+
+	ResStore s;
+	if (resStoreOpen(&s, argv[argc - 1])) {
+		fprintf(stderr, "resquery: %s is not a store, or is from a machine with another byte order\n", argv[argc - 1]);
+		return 1;
+	}
+	const ResHeader *h = &s.sh.h;
+	for (i = 0; i < nFnArgs; i++) {
+		int fn;
+		for (fn = 0; fn < h->funcCount && strcmp(fnArgs[i], h->funcNames[fn]) != 0; fn++) {
+		}
+		if (fn == h->funcCount) {
+			fprintf(stderr, "resquery: no function %s in the store\n", fnArgs[i]);
+			return 1;
+		}
+		fnSel |= 1 << fn;
+	}
+	if (fnSel == 0) {
+		fnSel = ~0;
+	}
+	if (classSel == 0) {
+		classSel = ~0;
+	}
+	ResKey lo = {0, 0}, hi = {~(uint64_t)0, ~(uint64_t)0};
+	if (from != nil) {
+		unsigned char a[ResSlotBytes], b[ResSlotBytes];
+		if (resParseValue(h, from, a) || resParseValue(h, to, b)) {
+			fprintf(stderr, "resquery: invalid interval\n");
+			return 1;
+		}
+		lo = resKey(h, a);
+		hi = resKey(h, b);
+	}
+
+	// Find the selected records of each bucket.
+	cursor cur[ResMaxFuncs * ResStoreClasses];
+	int n = 0, fn, c;
+	for (fn = 0; fn < h->funcCount; fn++) {
+		for (c = 0; c < ResStoreClasses; c++) {
+			if (!(fnSel >> fn & 1) || !(classSel >> c & 1)) {
+				continue;
+			}
+			cursor *p = &cur[n++];
+			p->fn = fn;
+			p->class = c;
+			p->i = 0;
+			p->end = resStoreCount(&s, fn, c);
+			if (from == nil || c == ResStoreMisrounded || c == ResStoreTop || c == ResStoreHist || c == ResStoreSample) {
+				continue;
+			}
+			p->i = resStoreLowerBound(&s, fn, c, lo);
+			p->end = resStoreLowerBound(&s, fn, c, keySucc(hi));
+			if (isRanges(c) && 0 < p->i) {
+				// The range or node before may end inside the
+				// interval.
+				ResRecord r;
+				resStoreGet(&s, fn, c, p->i - 1, &r);
+				if (resKeyCmp(lo, resKey(h, r.v[ResLimit1])) < 0) {
+					p->i--;
+				}
+			}
+			if (p->end < p->i) {
+				p->end = p->i;
+			}
+		}
+	}
+
+	setvbuf(stdout, nil, _IOFBF, ResBufferBytes);
+	if (count) {
+		for (i = 0; i < n; i++) {
+			printf("%3s %-10s %ld\n", h->funcNames[cur[i].fn], classNames[cur[i].class], (long)(cur[i].end - cur[i].i));
+		}
+		return fflush(stdout) != 0;
+	}
+
+	ResText t;
+	resTextInit(&t, h);
+	ResRecord r;
+
+	// Merge the points of the selected buckets, in the order of x,
+	// and of the functions for equal x.
+	for (;;) {
+		cursor *min = nil;
+		ResKey mk = {0, 0};
+		for (i = 0; i < n; i++) {
+			cursor *p = &cur[i];
+			if (p->class < ResBetter || ResWrong < p->class || p->i == p->end) {
+				continue;
+			}
+			ResKey k = resStoreKey(&s, p->fn, p->class, p->i);
+			if (min == nil || resKeyCmp(k, mk) < 0 || resKeyCmp(k, mk) == 0 && p->fn < min->fn) {
+				min = p;
+				mk = k;
+			}
+		}
+		if (min == nil) {
+			break;
+		}
+		resStoreGet(&s, min->fn, min->class, min->i++, &r);
+		resText(&t, stdout, &r);
+	}
+
+	int rest = 0;
+	static const int restClasses[] = {ResStoreRanges, ResStoreMisrounded, ResStoreTop, ResStoreHist};
+	int k;
+	for (k = 0; k < 4; k++) {
+		c = restClasses[k];
+		for (i = 0; i < n; i++) {
+			if (cur[i].class == c) {
+				rest = 1;
+				printBucket(&s, &t, &cur[i], merge);
+			}
+		}
+	}
+	// The levels of the pyramid of each function, then its samples, as
+	// in the report.
+	for (i = 0; i < n; i++) {
+		if (ResStorePyramid <= cur[i].class && cur[i].class < ResStoreSample) {
+			rest = 1;
+			printBucket(&s, &t, &cur[i], merge);
+		}
+	}
+	for (i = 0; i < n; i++) {
+		if (cur[i].class == ResStoreSample) {
+			rest = 1;
+			printBucket(&s, &t, &cur[i], merge);
+		}
+	}
+	if (rest) {
+		resTextEnd(&t, stdout);
+	}
+	resStoreClose(&s);
+	if (fflush(stdout)) {
+		fprintf(stderr, "resquery: write error\n");
+		return 1;
+	}
+	return 0;
+}
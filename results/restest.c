@@ -0,0 +1,168 @@
+// Copyright © 2020 Neven Sajko. All rights reserved.
+
+// Tests that reports in the text form read back as they were written,
+// with the kind of their values told from their fields, also when the
+// first ones fill or overflow them, e.g. a huge negative double x.
+//
+// Usage:
+//
+//    restest
+//
+// It prints the cases that fail; the exit status is 0 if none do.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "results.h"
+
+#define nil 0
+
+static const char *const funcNames[] = {"sin", "cos"};
+
+// A point of function fn, at x, with values like those of sin.
+static
+void
+point(const ResHeader *h, ResRecord *r, int fn, long double x) {
+	memset(r, 0, sizeof(*r));
+	r->tag = ResPoint;
+	r->fn = fn;
+	r->status = ResWorse;
+	r->bits = 3;
+	r->diff = 7;
+	long double v[4] = {x, -1/3.0L, -1/3.0L*(1 + 0x1p-50L), -1/3.0L*(1 - 0x1p-52L)};
+	int i;
+	for (i = 0; i < 4; i++) {
+		if (h->valueKind == ResValueDouble) {
+			double d = (double)v[i];
+			resSetValue(h, r->v[i], &d);
+		} else if (h->valueKind == ResValueLdbl) {
+			resSetValue(h, r->v[i], &v[i]);
+		} else {
+#ifdef __FLT128_MANT_DIG__
+			_Float128 q = (_Float128)v[i];
+			resSetValue(h, r->v[i], &q);
+#endif
+		}
+	}
+}
+
+// A range of function fn, of the one value x, with the values of the
+// point at x.
+static
+void
+range(const ResHeader *h, ResRecord *r, int fn, long double x) {
+	ResRecord p;
+	point(h, &p, fn, x);
+	memset(r, 0, sizeof(*r));
+	r->tag = ResRange;
+	r->fn = fn;
+	r->count[0] = 3;
+	r->count[1] = 1;
+	r->max[0] = 12;
+	r->max[1] = 4;
+	int i;
+	for (i = 0; i < ResMaxValues; i++) {
+		memcpy(r->v[i], p.v[i%4], sizeof(r->v[i]));
+	}
+	memcpy(r->v[ResLimit1], p.v[ResX], sizeof(r->v[ResLimit1]));
+}
+
+// Writes the records in the text form, reads them back, and compares.
+// Returns 0 if they are the same, and of the same kind.
+static
+int
+roundTrip(const char *name, int kind, const ResRecord *recs, int n) {
+	ResHeader h;
+	resInitHeader(&h, kind, 2, 32, funcNames);
+	FILE *f = tmpfile();
+	if (f == nil) {
+		fprintf(stderr, "restest: cannot create a temporary file\n");
+		return 1;
+	}
+	ResText t;
+	resTextInit(&t, &h);
+	int i;
+	for (i = 0; i < n; i++) {
+		resText(&t, f, &recs[i]);
+	}
+	resTextEnd(&t, f);
+	rewind(f);
+
+	ResTextReader tr;
+	resTextReaderInit(&tr, f);
+	int fail = 0;
+	for (i = 0; !fail; i++) {
+		ResRecord r;
+		int e = resReadText(&tr, &r);
+		if (e < 0) {
+			printf("%s: line %ld cannot be parsed\n", name, tr.line);
+			fail = 1;
+		} else if (e == 0) {
+			if (i != n) {
+				printf("%s: %d records read, of %d\n", name, i, n);
+				fail = 1;
+			}
+			break;
+		} else if (n <= i) {
+			printf("%s: more than %d records read\n", name, n);
+			fail = 1;
+		} else if (tr.h.valueKind != kind) {
+			printf("%s: values of kind %d read, of kind %d\n", name, tr.h.valueKind, kind);
+			fail = 1;
+		} else {
+			char a[ResMaxTextBytes], b[ResMaxTextBytes];
+			resFormat(&h, &recs[i], a);
+			resFormat(&tr.h, &r, b);
+			if (strcmp(a, b) != 0) {
+				printf("%s: record %d differs:\n%s%s", name, i, a, b);
+				fail = 1;
+			}
+		}
+	}
+	fclose(f);
+	return fail;
+}
+
+int
+main(void) {
+	// The x of the first points and ranges, and the kinds.
+	static const struct {
+		const char *name;
+		int kind;
+		long double x;
+	} cases[] = {
+		{"double", ResValueDouble, 1.25L},
+		{"negative double", ResValueDouble, -1.25L},
+		{"huge negative double", ResValueDouble, -1.78173484067359415295e+308L},
+		{"tiny negative double", ResValueDouble, -3e-310L},
+		{"long double", ResValueLdbl, 1.25L},
+		{"huge negative long double", ResValueLdbl, -1.78173484067359415295e+308L},
+		{"long double, four-digit exponent", ResValueLdbl, -1.5e+4000L},
+#ifdef __FLT128_MANT_DIG__
+		{"binary128", ResValueF128, -1.25L},
+		{"binary128, four-digit exponent", ResValueF128, -1.5e+4000L},
+#endif
+	};
+	int fails = 0;
+	size_t i;
+	for (i = 0; i < sizeof(cases)/sizeof(cases[0]); i++) {
+		ResHeader h;
+		resInitHeader(&h, cases[i].kind, 2, 32, funcNames);
+		ResRecord recs[4];
+		char name[80];
+
+		// Points, first, then ranges.
+		point(&h, &recs[0], 0, cases[i].x);
+		point(&h, &recs[1], 1, cases[i].x);
+		range(&h, &recs[2], 0, cases[i].x);
+		range(&h, &recs[3], 1, 1.25L);
+		sprintf(name, "%s, points", cases[i].name);
+		fails += roundTrip(name, cases[i].kind, recs, 4);
+
+		// Only ranges.
+		sprintf(name, "%s, ranges", cases[i].name);
+		fails += roundTrip(name, cases[i].kind, &recs[2], 2);
+	}
+	return fails != 0;
+}
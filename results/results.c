@@ -0,0 +1,1074 @@
+// Reading, writing and rendering of the binary form of the checker's
+// report, see results.h.
+
+#define __STDC_WANT_IEC_60559_TYPES_EXT__
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "results.h"
+
+#define nil 0
+
+enum {
+	ResOrder = 0x01020304,
+
+	// Offsets of the value slots and sizes, apart from the slots.
+	PointHeadBytes = 16,
+	RangeHeadBytes = 32,
+	MisroundedBytes = 24,
+	HistHeadBytes = 16,
+	SampleHeadBytes = 32,
+};
+
+static const char *const statusNames[] = {nil, "better", "worse ", "wrong "};
+static const char *const topNames[] = {"best iscor", "worst iscor", "best fscor", "worst fscor"};
+static const char *const histNames[] = {"old", "new"};
+
+void
+resInitHeader(ResHeader *h, int valueKind, int funcCount, int pointsInOneRange, const char *const *funcNames) {
+	memset(h, 0, sizeof(*h));
+	memcpy(h->magic, ResMagic, sizeof(h->magic));
+	h->order = ResOrder;
+	h->valueKind = (uint8_t)valueKind;
+	h->funcCount = (uint8_t)funcCount;
+	h->pointsInOneRange = (uint16_t)pointsInOneRange;
+	int i;
+	for (i = 0; i < funcCount; i++) {
+		strncpy(h->funcNames[i], funcNames[i], sizeof(h->funcNames[i]) - 1);
+	}
+}
+
+// Bytes of the value's bit pattern, without any padding.
+int
+resValueBytes(int valueKind) {
+	switch (valueKind) {
+	case ResValueDouble:
+		return 8;
+	case ResValueLdbl:
+		return 10;
+	}
+	return 16;
+}
+
+static
+size_t
+slotBytes(const ResHeader *h) {
+	return h->valueKind == ResValueDouble ? 8 : ResSlotBytes;
+}
+
+// Copies the bit pattern of the value of the header's kind into slot.
+void
+resSetValue(const ResHeader *h, unsigned char *slot, const void *value) {
+	memset(slot, 0, ResSlotBytes);
+	memcpy(slot, value, (size_t)resValueBytes(h->valueKind));
+}
+
+// Size of records with the given tag, or 0 for an invalid tag.
+size_t
+resRecordBytes(const ResHeader *h, int tag) {
+	switch (tag) {
+	case ResPoint:
+		return PointHeadBytes + 4*slotBytes(h);
+	case ResRange:
+	case ResPyramid:
+		return RangeHeadBytes + ResMaxValues*slotBytes(h);
+	case ResMisrounded:
+		return MisroundedBytes;
+	case ResTop:
+		return PointHeadBytes + 5*slotBytes(h);
+	case ResHist:
+		return HistHeadBytes + slotBytes(h) + ResHistBuckets*8;
+	case ResSample:
+		return SampleHeadBytes + ResMaxValues*slotBytes(h);
+	}
+	return 0;
+}
+
+// Encodes r into buf, which must have room for ResMaxRecordBytes, and
+// returns the size of the record.
+size_t
+resEncode(const ResHeader *h, const ResRecord *r, unsigned char *buf) {
+	size_t n = resRecordBytes(h, r->tag), w = slotBytes(h), i;
+	memset(buf, 0, n);
+	buf[0] = (unsigned char)r->tag;
+	buf[1] = (unsigned char)r->fn;
+	switch (r->tag) {
+	case ResPoint:
+	case ResTop:
+		buf[2] = (unsigned char)r->status;
+		buf[3] = (unsigned char)r->bits;
+		memcpy(&buf[8], &r->diff, 8);
+		for (i = 0; i < (r->tag == ResTop ? 5 : 4); i++) {
+			memcpy(&buf[PointHeadBytes + i*w], r->v[i], w);
+		}
+		break;
+	case ResRange:
+	case ResPyramid:
+		buf[2] = (unsigned char)r->status;
+		memcpy(&buf[4], &r->count[0], 4);
+		memcpy(&buf[8], &r->count[1], 4);
+		memcpy(&buf[16], &r->max[0], 8);
+		memcpy(&buf[24], &r->max[1], 8);
+		for (i = 0; i < ResMaxValues; i++) {
+			memcpy(&buf[RangeHeadBytes + i*w], r->v[i], w);
+		}
+		break;
+	case ResMisrounded:
+		memcpy(&buf[8], &r->misrounded, 8);
+		memcpy(&buf[16], &r->total, 8);
+		break;
+	case ResHist:
+		buf[2] = (unsigned char)r->status;
+		memcpy(&buf[8], &r->total, 8);
+		memcpy(&buf[HistHeadBytes], r->v[0], w);
+		memcpy(&buf[HistHeadBytes + w], r->counts, ResHistBuckets*8);
+		break;
+	case ResSample:
+		buf[2] = (unsigned char)r->status;
+		memcpy(&buf[8], &r->total, 8);
+		memcpy(&buf[16], &r->counts[ResHistOld], 8);
+		memcpy(&buf[24], &r->counts[ResHistNew], 8);
+		for (i = 0; i < ResMaxValues; i++) {
+			memcpy(&buf[SampleHeadBytes + i*w], r->v[i], w);
+		}
+		break;
+	}
+	return n;
+}
+
+// Decodes the record at the start of the n bytes at buf into r, and
+// returns its size, or 0 if there is no valid record.
+size_t
+resDecode(const ResHeader *h, const unsigned char *buf, size_t n, ResRecord *r) {
+	if (n == 0) {
+		return 0;
+	}
+	size_t m = resRecordBytes(h, buf[0]), w = slotBytes(h), i;
+	if (m == 0 || n < m || h->funcCount <= buf[1]) {
+		return 0;
+	}
+	memset(r, 0, sizeof(*r));
+	r->tag = buf[0];
+	r->fn = buf[1];
+	switch (r->tag) {
+	case ResPoint:
+		r->status = buf[2];
+		r->bits = buf[3];
+		memcpy(&r->diff, &buf[8], 8);
+		for (i = 0; i < 4; i++) {
+			memcpy(r->v[i], &buf[PointHeadBytes + i*w], w);
+		}
+		if (r->status < ResBetter || ResWrong < r->status) {
+			return 0;
+		}
+		break;
+	case ResTop:
+		r->status = buf[2];
+		r->bits = buf[3];
+		memcpy(&r->diff, &buf[8], 8);
+		for (i = 0; i < 5; i++) {
+			memcpy(r->v[i], &buf[PointHeadBytes + i*w], w);
+		}
+		if (ResTopLists <= r->status) {
+			return 0;
+		}
+		break;
+	case ResRange:
+	case ResPyramid:
+		r->status = buf[2];
+		memcpy(&r->count[0], &buf[4], 4);
+		memcpy(&r->count[1], &buf[8], 4);
+		memcpy(&r->max[0], &buf[16], 8);
+		memcpy(&r->max[1], &buf[24], 8);
+		for (i = 0; i < ResMaxValues; i++) {
+			memcpy(r->v[i], &buf[RangeHeadBytes + i*w], w);
+		}
+		if (r->tag == ResRange ? r->status != 0 : r->status < 1 || ResPyramidLevels < r->status) {
+			return 0;
+		}
+		break;
+	case ResMisrounded:
+		memcpy(&r->misrounded, &buf[8], 8);
+		memcpy(&r->total, &buf[16], 8);
+		break;
+	case ResHist:
+		r->status = buf[2];
+		memcpy(&r->total, &buf[8], 8);
+		memcpy(r->v[0], &buf[HistHeadBytes], w);
+		memcpy(r->counts, &buf[HistHeadBytes + w], ResHistBuckets*8);
+		if (ResHistNew < r->status) {
+			return 0;
+		}
+		break;
+	case ResSample:
+		r->status = buf[2];
+		memcpy(&r->total, &buf[8], 8);
+		memcpy(&r->counts[ResHistOld], &buf[16], 8);
+		memcpy(&r->counts[ResHistNew], &buf[24], 8);
+		for (i = 0; i < ResMaxValues; i++) {
+			memcpy(r->v[i], &buf[SampleHeadBytes + i*w], w);
+		}
+		if (ResSampleOctants < r->status) {
+			return 0;
+		}
+		break;
+	}
+	return m;
+}
+
+// Returns 0 on success.
+int
+resWriteHeader(FILE *f, const ResHeader *h) {
+	return fwrite(h, sizeof(*h), 1, f) != 1;
+}
+
+// Returns 0 on success.
+int
+resWrite(FILE *f, const ResHeader *h, const ResRecord *r) {
+	unsigned char buf[ResMaxRecordBytes];
+	size_t n = resEncode(h, r, buf);
+	return fwrite(buf, 1, n, f) != n;
+}
+
+// Checks that h is a valid header in the byte order of this machine,
+// and terminates the function names. Returns 0 on success.
+int
+resCheckHeader(ResHeader *h) {
+	if (memcmp(h->magic, ResMagic, sizeof(h->magic)) != 0 || h->order != ResOrder ||
+		h->valueKind < ResValueDouble || ResValueF128 < h->valueKind || ResMaxFuncs < h->funcCount) {
+		return -1;
+	}
+	int i;
+	for (i = 0; i < ResMaxFuncs; i++) {
+		h->funcNames[i][sizeof(h->funcNames[i]) - 1] = '\0';
+	}
+	return 0;
+}
+
+// Returns 0 on success, and -1 if the stream does not start with a
+// valid header in the byte order of this machine.
+int
+resReadHeader(FILE *f, ResHeader *h) {
+	if (fread(h, sizeof(*h), 1, f) != 1) {
+		return -1;
+	}
+	return resCheckHeader(h);
+}
+
+// Reads the next record into r. Returns 1 for a record, 0 at the end of
+// the stream, and -1 for an invalid or truncated record.
+int
+resRead(FILE *f, const ResHeader *h, ResRecord *r) {
+	unsigned char buf[ResMaxRecordBytes];
+	int c = fgetc(f);
+	if (c == EOF) {
+		return 0;
+	}
+	size_t n = resRecordBytes(h, c);
+	if (n == 0) {
+		return -1;
+	}
+	buf[0] = (unsigned char)c;
+	if (fread(&buf[1], 1, n - 1, f) != n - 1 || resDecode(h, buf, n, r) != n) {
+		return -1;
+	}
+	return 1;
+}
+
+ResKey
+resKey(const ResHeader *h, const unsigned char *slot) {
+	ResKey k;
+	uint64_t sign;
+	switch (h->valueKind) {
+	case ResValueDouble:
+		memcpy(&k.hi, slot, 8);
+		k.lo = 0;
+		sign = k.hi >> 63;
+		break;
+	case ResValueLdbl: {
+		// The significand, then the sign and the exponent.
+		uint64_t m;
+		uint16_t se;
+		memcpy(&m, slot, 8);
+		memcpy(&se, &slot[8], 2);
+		k.hi = (uint64_t)se << 48 | m >> 16;
+		k.lo = m << 48;
+		sign = se >> 15;
+		break;
+	}
+	default:
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+		memcpy(&k.hi, slot, 8);
+		memcpy(&k.lo, &slot[8], 8);
+#else
+		memcpy(&k.lo, slot, 8);
+		memcpy(&k.hi, &slot[8], 8);
+#endif
+		sign = k.hi >> 63;
+		break;
+	}
+	// Sign and magnitude to an unsigned order.
+	if (sign) {
+		k.hi = ~k.hi;
+		k.lo = ~k.lo;
+	} else {
+		k.hi |= (uint64_t)1 << 63;
+	}
+	return k;
+}
+
+// The key of the encoded record at rec: of x for a point, of the lower
+// limit for a range or a node of the pyramid, and zero otherwise.
+ResKey
+resRecordKey(const ResHeader *h, const unsigned char *rec) {
+	switch (rec[0]) {
+	case ResPoint:
+		return resKey(h, &rec[PointHeadBytes]);
+	case ResRange:
+	case ResPyramid:
+		return resKey(h, &rec[RangeHeadBytes]);
+	}
+	ResKey k = {0, 0};
+	return k;
+}
+
+int
+resKeyCmp(ResKey a, ResKey b) {
+	if (a.hi != b.hi) {
+		return a.hi < b.hi ? -1 : 1;
+	}
+	if (a.lo != b.lo) {
+		return a.lo < b.lo ? -1 : 1;
+	}
+	return 0;
+}
+
+// Parses s into slot as a value of the header's kind. Returns 0 on
+// success.
+int
+resParseValue(const ResHeader *h, const char *s, unsigned char *slot) {
+	char *end;
+	switch (h->valueKind) {
+	case ResValueDouble: {
+		double x = strtod(s, &end);
+		resSetValue(h, slot, &x);
+		break;
+	}
+	case ResValueLdbl: {
+		long double x = strtold(s, &end);
+		resSetValue(h, slot, &x);
+		break;
+	}
+	default: {
+#ifdef __FLT128_MANT_DIG__
+		_Float128 x = strtof128(s, &end);
+		resSetValue(h, slot, &x);
+#else
+		end = (char *)s;
+#endif
+		break;
+	}
+	}
+	return end == s || *end != '\0';
+}
+
+// Formats the value in slot as a field of the text form.
+void
+resFormatValue(const ResHeader *h, const unsigned char *slot, char *out) {
+	switch (h->valueKind) {
+	case ResValueDouble: {
+		double x;
+		memcpy(&x, slot, sizeof(x));
+		resFormatDouble(x, out);
+		break;
+	}
+	case ResValueLdbl: {
+		long double x = 0;
+		memcpy(&x, slot, 10);
+		sprintf(out, "%28.20Le", x);
+		break;
+	}
+	default: {
+#ifdef __FLT128_MANT_DIG__
+		_Float128 x;
+		char buf[ResValueTextBytes];
+		memcpy(&x, slot, sizeof(x));
+		strfromf128(buf, sizeof(buf), "%.35e", x);
+		sprintf(out, "%44s", buf);
+#else
+		sprintf(out, "%44s", "?");
+#endif
+		break;
+	}
+	}
+}
+
+void
+resTextInit(ResText *t, const ResHeader *h) {
+	t->h = h;
+	t->ranges = 0;
+	t->fn = -1;
+	t->top = 0;
+	t->list = -1;
+	t->hist = -1;
+	t->level = -1;
+	t->sample = -1;
+}
+
+// Prints the start of the range section, and the function names and
+// separators up to function fn; fn equal to the number of functions
+// ends the section.
+static
+void
+rangesUpTo(ResText *t, FILE *out, int fn) {
+	if (!t->ranges) {
+		fprintf(out, "\n\nPointsInOneRange: %5d\n\n\n", t->h->pointsInOneRange);
+		t->ranges = 1;
+	}
+	while (t->fn < fn) {
+		if (0 <= t->fn) {
+			fprintf(out, "\n\n");
+		}
+		t->fn++;
+		if (t->fn < t->h->funcCount) {
+			fprintf(out, "%3s:\n", t->h->funcNames[t->fn]);
+		}
+	}
+}
+
+// Formats r into its lines in the text form, in buf, which must have
+// room for ResMaxTextBytes, and returns their length. The lines of a
+// range or a node of the pyramid end with the blank line that follows
+// it.
+int
+resFormat(const ResHeader *h, const ResRecord *r, char *buf) {
+	char v[ResMaxValues][ResValueTextBytes];
+	int i;
+	switch (r->tag) {
+	case ResPoint: {
+		for (i = 0; i < 4; i++) {
+			resFormatValue(h, r->v[i], v[i]);
+		}
+		char about[30];
+		if (r->bits == 0) {
+			sprintf(about, "Exponents or signs differ !");
+		} else {
+			sprintf(about, "Mantissas differ in %2d bits", r->bits);
+		}
+		return sprintf(buf, "%6s %s %3s: %30s %22ld %s %s %s\n", statusNames[r->status], v[ResX],
+			h->funcNames[r->fn], about, (long)r->diff, v[ResOld], v[ResNew], v[ResAccurate]);
+	}
+	case ResRange:
+	case ResPyramid:
+		for (i = 0; i < ResMaxValues; i++) {
+			resFormatValue(h, r->v[i], v[i]);
+		}
+		return sprintf(buf, "%s %s\n%7d %22ld %s %s\n%7d %22ld %s %s\n%s\n\n",
+			v[ResLimit0], v[ResLimit1],
+			(int)r->count[0], (long)r->max[0], v[ResImprovMaxScor], v[ResImprovMean2],
+			(int)r->count[1], (long)r->max[1], v[ResWorseMaxScor], v[ResWorseMean2],
+			v[ResMean1]);
+	case ResMisrounded:
+		return sprintf(buf, "%3s: %6ld of %6d not correctly rounded\n", h->funcNames[r->fn], (long)r->misrounded, (int)r->total);
+	case ResTop:
+		for (i = 0; i < 5; i++) {
+			resFormatValue(h, r->v[i], v[i]);
+		}
+		return sprintf(buf, "%22ld %s %s %s %s %s\n", (long)r->diff, v[ResScore],
+			v[ResX], v[ResOld], v[ResNew], v[ResAccurate]);
+	case ResHist: {
+		resFormatValue(h, r->v[0], v[0]);
+		int n = sprintf(buf, "%s %10ld", v[0], (long)r->total);
+		for (i = 0; i < ResHistBuckets; i++) {
+			n += sprintf(&buf[n], " %ld", (long)r->counts[i]);
+		}
+		buf[n++] = '\n';
+		buf[n] = '\0';
+		return n;
+	}
+	case ResSample: {
+		for (i = 0; i < ResMaxValues; i++) {
+			resFormatValue(h, r->v[i], v[i]);
+		}
+		char octant[12] = "all";
+		if (r->status < ResSampleOctants) {
+			sprintf(octant, "%d", r->status);
+		}
+		return sprintf(buf, "%s %3s %10ld %10ld %10ld %s %s %s %s %s %s\n", v[ResBinade], octant,
+			(long)r->total, (long)r->counts[ResHistOld], (long)r->counts[ResHistNew],
+			v[ResOldRate], v[ResOldLow], v[ResOldHigh], v[ResNewRate], v[ResNewLow], v[ResNewHigh]);
+	}
+	}
+	buf[0] = '\0';
+	return 0;
+}
+
+// Prints r in the text form.
+void
+resText(ResText *t, FILE *out, const ResRecord *r) {
+	char buf[ResMaxTextBytes];
+	switch (r->tag) {
+	case ResRange:
+		rangesUpTo(t, out, r->fn);
+		break;
+	case ResMisrounded:
+		rangesUpTo(t, out, t->h->funcCount);
+		break;
+	case ResTop:
+		rangesUpTo(t, out, t->h->funcCount);
+		if (!t->top) {
+			fprintf(out, "\n\nTop: %5d\n\n\n", ResTopMax);
+			t->top = 1;
+		}
+		if (t->list != r->fn*ResTopLists + r->status) {
+			if (0 <= t->list) {
+				fprintf(out, "\n");
+			}
+			t->list = r->fn*ResTopLists + r->status;
+			fprintf(out, "%3s %s:\n", t->h->funcNames[r->fn], topNames[r->status]);
+		}
+		break;
+	case ResHist:
+		rangesUpTo(t, out, t->h->funcCount);
+		if (t->hist < 0) {
+			fprintf(out, "\n\nHistograms: %5d\n\n\n", ResHistBuckets);
+		}
+		if (t->hist != r->fn*2 + r->status) {
+			if (0 <= t->hist) {
+				fprintf(out, "\n");
+			}
+			t->hist = r->fn*2 + r->status;
+			fprintf(out, "%3s %s:\n", t->h->funcNames[r->fn], histNames[r->status]);
+		}
+		break;
+	case ResPyramid:
+		rangesUpTo(t, out, t->h->funcCount);
+		if (t->level < 0) {
+			fprintf(out, "\n\nPyramid: %5d\n\n\n", ResPyramidFactor);
+		}
+		if (t->level != r->fn*ResPyramidLevels + r->status - 1) {
+			if (0 <= t->level) {
+				fprintf(out, "\n");
+			}
+			t->level = r->fn*ResPyramidLevels + r->status - 1;
+			fprintf(out, "%3s level %d:\n", t->h->funcNames[r->fn], r->status);
+		}
+		break;
+	case ResSample:
+		rangesUpTo(t, out, t->h->funcCount);
+		if (t->sample < 0) {
+			fprintf(out, "\n\nSamples: %5d\n\n\n", ResSampleOctants);
+		}
+		if (t->sample != r->fn) {
+			if (0 <= t->sample) {
+				fprintf(out, "\n");
+			}
+			t->sample = r->fn;
+			fprintf(out, "%3s samples:\n", t->h->funcNames[r->fn]);
+		}
+		break;
+	}
+	int n = resFormat(t->h, r, buf);
+	fwrite(buf, 1, (size_t)n, out);
+}
+
+// Ends the text form, for streams that end in the point or the range
+// section; it does nothing after the others.
+void
+resTextEnd(ResText *t, FILE *out) {
+	rangesUpTo(t, out, t->h->funcCount);
+}
+
+void
+resTextReaderInit(ResTextReader *t, FILE *f) {
+	memset(t, 0, sizeof(*t));
+	t->f = f;
+	resInitHeader(&t->h, ResValueDouble, 0, 0, nil);
+	t->fn = -1;
+	t->list = -1;
+	int i;
+	for (i = 0; i < ResMaxFuncs; i++) {
+		t->pos[i] = -1;
+	}
+}
+
+// Reads a line into buf, without the newline. Returns 0 at the end of
+// the file.
+static
+int
+readLine(ResTextReader *t, char *buf) {
+	if (fgets(buf, ResMaxTextBytes, t->f) == nil) {
+		return 0;
+	}
+	t->line++;
+	size_t n = strlen(buf);
+	if (0 < n && buf[n - 1] == '\n') {
+		buf[n - 1] = '\0';
+	}
+	return 1;
+}
+
+// The index of the function with the name, added to the header if it
+// is new, or -1 if there is no room for it.
+static
+int
+funcIndex(ResTextReader *t, const char *name) {
+	int i;
+	for (i = 0; i < t->h.funcCount; i++) {
+		if (strcmp(t->h.funcNames[i], name) == 0) {
+			return i;
+		}
+	}
+	if (i == ResMaxFuncs || sizeof(t->h.funcNames[i]) <= strlen(name)) {
+		return -1;
+	}
+	strcpy(t->h.funcNames[i], name);
+	t->h.funcCount++;
+	return i;
+}
+
+// The kind of the values of a field of the text form, the width bytes
+// at s, or -1 if it could be a double or a long double. The digits of a
+// binary128 and the four-digit exponents of the long doubles tell them
+// apart; otherwise it is the width of the field, but only if the value
+// does not overflow it: a negative double with a three-digit exponent,
+// such as -1.78173484067359415295e+308, is as wide as a long double.
+static
+int
+fieldKind(const char *s, size_t width) {
+	size_t pad = 0;
+	while (pad < width && s[pad] == ' ') {
+		pad++;
+	}
+	const char *dot = memchr(s, '.', width), *e = memchr(s, 'e', width);
+	if (dot == nil || e == nil || e < dot) {
+		return -1;
+	}
+	if (e - dot - 1 == 35) {
+		return ResValueF128;
+	}
+	if (&s[width] - e == 6) {
+		return ResValueLdbl;
+	}
+	if (width == 27) {
+		return ResValueDouble;
+	}
+	if (pad == 0) {
+		return -1;
+	}
+	return width == 28 ? ResValueLdbl : width == 44 ? ResValueF128 : -1;
+}
+
+// Takes the kind of the values from the n fields at s, each but the
+// first after a space, unless it is known already. While no field tells
+// it, the values are read as doubles.
+static
+void
+detectKind(ResTextReader *t, const char *s, int n) {
+	for (; !t->kindKnown && 0 < n; n--) {
+		size_t pad = strspn(s, " "), width = pad + strcspn(&s[pad], " ");
+		int kind = fieldKind(s, width);
+		if (0 <= kind) {
+			t->kindKnown = 1;
+			t->h.valueKind = kind;
+		}
+		s += width;
+		if (*s == ' ') {
+			s++;
+		}
+	}
+}
+
+// Parses the next value of the line at *s into slot, and advances *s
+// past it. Returns 0 on success.
+static
+int
+parseValue(ResTextReader *t, const char **s, unsigned char *slot) {
+	char tok[ResValueTextBytes];
+	const char *p = *s;
+	while (*p == ' ') {
+		p++;
+	}
+	size_t n = strcspn(p, " ");
+	if (n == 0 || sizeof(tok) <= n) {
+		return -1;
+	}
+	memcpy(tok, p, n);
+	tok[n] = '\0';
+	*s = p + n;
+	return resParseValue(&t->h, tok, slot);
+}
+
+// Parses the next integer of the line at *s, and advances *s past it.
+// Returns 0 on success.
+static
+int
+parseInt(const char **s, int64_t *v) {
+	char *end;
+	*v = strtoll(*s, &end, 10);
+	if (end == *s) {
+		return -1;
+	}
+	*s = end;
+	return 0;
+}
+
+static
+int
+parsePoint(ResTextReader *t, const char *line, ResRecord *r) {
+	const char *colon = strchr(line, ':');
+	if (colon == nil || colon - line < 12) {
+		return -1;
+	}
+	for (r->status = ResBetter; r->status <= ResWrong; r->status++) {
+		if (strncmp(line, statusNames[r->status], 6) == 0) {
+			break;
+		}
+	}
+	char name[4];
+	const char *p = colon - 3;
+	while (*p == ' ') {
+		p++;
+	}
+	memcpy(name, p, (size_t)(colon - p));
+	name[colon - p] = '\0';
+	if ((r->fn = funcIndex(t, name)) < 0) {
+		return -1;
+	}
+	p = colon + 1;
+	while (*p == ' ') {
+		p++;
+	}
+	const char *exps = "Exponents or signs differ !", *mant = "Mantissas differ in";
+	int64_t v;
+	if (strncmp(p, exps, strlen(exps)) == 0) {
+		r->bits = 0;
+		p += strlen(exps);
+	} else if (strncmp(p, mant, strlen(mant)) == 0) {
+		p += strlen(mant);
+		if (parseInt(&p, &v) || strncmp(p, " bits", 5) != 0) {
+			return -1;
+		}
+		r->bits = (int)v;
+		p += 5;
+	} else {
+		return -1;
+	}
+	if (parseInt(&p, &r->diff) || *p != ' ') {
+		return -1;
+	}
+	detectKind(t, &line[7], 1);
+	detectKind(t, &p[1], 3);
+	const char *x = &line[7];
+	if (parseValue(t, &x, r->v[ResX]) || parseValue(t, &p, r->v[ResOld]) ||
+		parseValue(t, &p, r->v[ResNew]) || parseValue(t, &p, r->v[ResAccurate])) {
+		return -1;
+	}
+	r->tag = ResPoint;
+	return 0;
+}
+
+// Parses a range, from its first line, which is in line. Its lines are
+// all read first, so that any of their values can tell the kind.
+static
+int
+parseRange(ResTextReader *t, char *line, ResRecord *r) {
+	char more[3][ResMaxTextBytes];
+	const char *q[3];
+	int64_t c[2];
+	int i;
+	for (i = 0; i < 3; i++) {
+		q[i] = more[i];
+		if (!readLine(t, more[i]) || (i < 2 && (parseInt(&q[i], &c[i]) || parseInt(&q[i], &r->max[i]) || *q[i] != ' '))) {
+			return -1;
+		}
+	}
+	detectKind(t, line, 2);
+	for (i = 0; i < 2; i++) {
+		detectKind(t, &q[i][1], 2);
+	}
+	detectKind(t, q[2], 1);
+	const char *p = line;
+	if (t->fn < 0 || parseValue(t, &p, r->v[ResLimit0]) || parseValue(t, &p, r->v[ResLimit1])) {
+		return -1;
+	}
+	for (i = 0; i < 2; i++) {
+		if (parseValue(t, &q[i], r->v[ResImprovMaxScor + 2*i]) || parseValue(t, &q[i], r->v[ResImprovMean2 + 2*i])) {
+			return -1;
+		}
+		r->count[i] = (int32_t)c[i];
+	}
+	if (parseValue(t, &q[2], r->v[ResMean1])) {
+		return -1;
+	}
+	r->tag = ResRange;
+	r->fn = t->fn;
+	return 0;
+}
+
+// Parses the function name at the start of a heading in line, which
+// has the colon, into t->fn. Returns the space after the name, or nil
+// for an invalid line.
+static
+const char *
+headingFunc(ResTextReader *t, const char *line, const char *colon) {
+	const char *p = line;
+	while (*p == ' ') {
+		p++;
+	}
+	const char *sp = strchr(p, ' ');
+	char name[4];
+	if (sp == nil || colon < sp || sp - p < 1 || (long)sizeof(name) <= sp - p) {
+		return nil;
+	}
+	memcpy(name, p, (size_t)(sp - p));
+	name[sp - p] = '\0';
+	if ((t->fn = funcIndex(t, name)) < 0) {
+		return nil;
+	}
+	return sp;
+}
+
+// Parses the heading of a top list, a histogram or samples in line, which has
+// the colon, into t->fn and the index of the name of the list in names,
+// of which there are n. Returns the index, or -1 for an invalid line.
+static
+int
+parseHeading(ResTextReader *t, const char *line, const char *colon, const char *const *names, int n) {
+	const char *sp = headingFunc(t, line, colon);
+	if (sp == nil) {
+		return -1;
+	}
+	int i;
+	for (i = 0; i < n; i++) {
+		if ((long)strlen(names[i]) == colon - sp - 1 && strncmp(sp + 1, names[i], strlen(names[i])) == 0) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+// Parses a line of the top section: a heading, or a record of the
+// list under it. Returns 1 for a record, 0 for a heading, and -1 for an
+// invalid line.
+static
+int
+parseTop(ResTextReader *t, const char *line, ResRecord *r) {
+	const char *p = line, *colon = strchr(line, ':');
+	if (colon != nil) {
+		t->list = parseHeading(t, line, colon, topNames, ResTopLists);
+		return t->list < 0 ? -1 : 0;
+	}
+	if (t->list < 0 || parseInt(&p, &r->diff) || parseValue(t, &p, r->v[ResScore]) ||
+		parseValue(t, &p, r->v[ResX]) || parseValue(t, &p, r->v[ResOld]) ||
+		parseValue(t, &p, r->v[ResNew]) || parseValue(t, &p, r->v[ResAccurate])) {
+		return -1;
+	}
+	r->tag = ResTop;
+	r->fn = t->fn;
+	r->status = t->list;
+	return 1;
+}
+
+// Parses a line of the histogram section, like parseTop.
+static
+int
+parseHist(ResTextReader *t, const char *line, ResRecord *r) {
+	const char *p = line, *colon = strchr(line, ':');
+	if (colon != nil) {
+		t->list = parseHeading(t, line, colon, histNames, 2);
+		return t->list < 0 ? -1 : 0;
+	}
+	if (t->list < 0 || parseValue(t, &p, r->v[0]) || parseInt(&p, &r->total)) {
+		return -1;
+	}
+	int i;
+	for (i = 0; i < ResHistBuckets; i++) {
+		if (parseInt(&p, &r->counts[i])) {
+			return -1;
+		}
+	}
+	r->tag = ResHist;
+	r->fn = t->fn;
+	r->status = t->list;
+	return 1;
+}
+
+// Parses a line of the sample section, like parseTop.
+static
+int
+parseSample(ResTextReader *t, const char *line, ResRecord *r) {
+	static const char *const sampleNames[] = {"samples"};
+	const char *p = line, *colon = strchr(line, ':');
+	if (colon != nil) {
+		t->list = parseHeading(t, line, colon, sampleNames, 1);
+		return t->list < 0 ? -1 : 0;
+	}
+	if (t->list < 0 || parseValue(t, &p, r->v[ResBinade])) {
+		return -1;
+	}
+	while (*p == ' ') {
+		p++;
+	}
+	int64_t o = ResSampleOctants;
+	if (strncmp(p, "all", strlen("all")) == 0) {
+		p += strlen("all");
+	} else if (parseInt(&p, &o) || o < 0 || ResSampleOctants <= o) {
+		return -1;
+	}
+	if (parseInt(&p, &r->total) || parseInt(&p, &r->counts[ResHistOld]) || parseInt(&p, &r->counts[ResHistNew])) {
+		return -1;
+	}
+	int i;
+	for (i = ResOldRate; i <= ResNewHigh; i++) {
+		if (parseValue(t, &p, r->v[i])) {
+			return -1;
+		}
+	}
+	r->tag = ResSample;
+	r->fn = t->fn;
+	r->status = (int)o;
+	return 1;
+}
+
+// Reads the next record of the text form into r. Returns 1 for a
+// record, 0 at the end of the file, and -1 for a line that cannot be
+// parsed, whose number is in t->line.
+int
+resReadText(ResTextReader *t, ResRecord *r) {
+	char line[ResMaxTextBytes];
+	memset(r, 0, sizeof(*r));
+	for (;;) {
+		if (!readLine(t, line)) {
+			return ferror(t->f) ? -1 : 0;
+		}
+		if (line[0] == '\0') {
+			continue;
+		}
+		if (!t->ranges) {
+			int64_t v;
+			const char *p = line + strlen("PointsInOneRange:");
+			if (strncmp(line, "PointsInOneRange:", strlen("PointsInOneRange:")) == 0) {
+				if (parseInt(&p, &v)) {
+					return -1;
+				}
+				t->h.pointsInOneRange = (uint16_t)v;
+				t->ranges = 1;
+				continue;
+			}
+			return parsePoint(t, line, r) ? -1 : 1;
+		}
+
+		if (strncmp(line, "Top:", strlen("Top:")) == 0) {
+			t->top = 1;
+			continue;
+		}
+		if (strncmp(line, "Histograms:", strlen("Histograms:")) == 0) {
+			t->top = 0;
+			t->hist = 1;
+			t->list = -1;
+			continue;
+		}
+		if (strncmp(line, "Pyramid:", strlen("Pyramid:")) == 0) {
+			t->top = 0;
+			t->hist = 0;
+			t->pyramid = 1;
+			t->list = -1;
+			continue;
+		}
+		if (strncmp(line, "Samples:", strlen("Samples:")) == 0) {
+			t->top = 0;
+			t->hist = 0;
+			t->pyramid = 0;
+			t->sample = 1;
+			t->list = -1;
+			continue;
+		}
+		if (t->sample) {
+			int e = parseSample(t, line, r);
+			if (e != 0) {
+				return e;
+			}
+			continue;
+		}
+		if (t->pyramid) {
+			const char *colon = strchr(line, ':');
+			if (colon != nil) {
+				// The function and the level of the following nodes.
+				const char *p = headingFunc(t, line, colon);
+				int64_t l;
+				if (p == nil || strncmp(p, " level ", strlen(" level ")) != 0) {
+					return -1;
+				}
+				p += strlen(" level");
+				if (parseInt(&p, &l) || p != colon || l < 1 || ResPyramidLevels < l) {
+					return -1;
+				}
+				t->list = (int)l;
+				continue;
+			}
+			if (t->list < 0 || parseRange(t, line, r)) {
+				return -1;
+			}
+			r->tag = ResPyramid;
+			r->status = t->list;
+			return 1;
+		}
+		if (t->top || t->hist) {
+			int e = t->top ? parseTop(t, line, r) : parseHist(t, line, r);
+			if (e != 0) {
+				return e;
+			}
+			continue;
+		}
+
+		const char *colon = strchr(line, ':');
+		if (colon != nil && colon[1] == '\0') {
+			// The name of the function of the following ranges.
+			const char *p = line;
+			while (*p == ' ') {
+				p++;
+			}
+			char name[4];
+			if (colon - p < 1 || (long)sizeof(name) <= colon - p) {
+				return -1;
+			}
+			memcpy(name, p, (size_t)(colon - p));
+			name[colon - p] = '\0';
+			if ((t->fn = funcIndex(t, name)) < 0) {
+				return -1;
+			}
+			if (t->pos[t->fn] < 0) {
+				t->pos[t->fn] = t->npos++;
+			}
+			continue;
+		}
+		if (colon != nil && strstr(line, "not correctly rounded") != nil) {
+			const char *p = line;
+			while (*p == ' ') {
+				p++;
+			}
+			char name[4];
+			if (colon - p < 1 || (long)sizeof(name) <= colon - p) {
+				return -1;
+			}
+			memcpy(name, p, (size_t)(colon - p));
+			name[colon - p] = '\0';
+			p = colon + 1;
+			const char *of = strstr(p, " of ");
+			if ((r->fn = funcIndex(t, name)) < 0 || of == nil || parseInt(&p, &r->misrounded)) {
+				return -1;
+			}
+			p = of + 4;
+			if (parseInt(&p, &r->total)) {
+				return -1;
+			}
+			r->tag = ResMisrounded;
+			return 1;
+		}
+		return parseRange(t, line, r) ? -1 : 1;
+	}
+}
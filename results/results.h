@@ -0,0 +1,424 @@
+// Include <stdint.h> and <stdio.h> before this header.
+
+// The binary form of the checker's report, see check/checker.c for the
+// text form. A stream is a ResHeader followed by records, in the same
+// order as the lines of the text form: first the points, then the
+// ranges, grouped by function, then (for the narrow formats) a count of
+// the misrounded results for each function, then, if the checker keeps
+// them, the top lists of each function, its histograms, the levels of
+// its pyramid, and the estimates of its error rates from the samples.
+//
+// Each record starts with its tag byte, and has a fixed size for its
+// tag and the header's value kind. The numbers are stored in the byte
+// order of the writer, which the header records, and the floating point
+// values as their bit patterns, each in a slot of ResSlotBytes bytes,
+// padded with zeros.
+
+enum {
+	// Kinds of floating point values.
+	ResValueDouble = 1,
+	ResValueLdbl,
+	ResValueF128,
+
+	// Maximum number of functions in one stream.
+	ResMaxFuncs = 8,
+
+	// Record tags.
+	ResPoint = 1,
+	ResRange,
+	ResMisrounded,
+	ResTop,
+	ResHist,
+	ResPyramid,
+	ResSample,
+
+	// Classification of points.
+	ResBetter = 1,
+	ResWorse,
+	ResWrong,
+
+	// Value slots of a record, enough for a range.
+	ResMaxValues = 7,
+
+	// Size of a value slot, for the extended kinds; doubles take 8.
+	ResSlotBytes = 16,
+
+	// Buckets of a histogram: 0 ULPs, then [2^(i-1), 2^i) ULPs for
+	// bucket i, the last one being unbounded.
+	ResHistBuckets = 32,
+
+	// The pyramid: a node of level l summarizes the ranges of
+	// ResPyramidFactor^l ranges of points, for the levels from 1 to
+	// ResPyramidLevels.
+	ResPyramidFactor = 32,
+	ResPyramidLevels = 4,
+
+	// The samples: the estimates are for each octant of x in a binade,
+	// and for the whole domain, in the status after the last octant.
+	ResSampleOctants = 8,
+
+	// Size of the largest record, a histogram.
+	ResMaxRecordBytes = 32 + ResHistBuckets*8,
+
+	// Enough for one value in the text form, with the terminating nul.
+	ResValueTextBytes = 50,
+
+	// Enough for one record in the text form.
+	ResMaxTextBytes = 8*ResValueTextBytes + ResHistBuckets*21 + 100,
+
+	// Buffer size for the binary streams.
+	ResBufferBytes = 1 << 20,
+};
+
+#define ResMagic "CNFRES1\n"
+
+typedef struct {
+	char magic[8];
+
+	// 0x01020304 in the byte order of the writer.
+	uint32_t order;
+
+	uint8_t valueKind, funcCount;
+	uint16_t pointsInOneRange;
+
+	char funcNames[ResMaxFuncs][4];
+} ResHeader;
+
+// A record in memory.
+//
+// For a point, v holds x, the old, the new and the accurate value; for
+// a range or a node of the pyramid, its limits, the maximum relative
+// scores of the improvements and the worsenings, their quadratic means,
+// and the arithmetic mean of all scores.
+typedef struct {
+	int tag, fn;
+
+	// Points: ResBetter, ResWorse or ResWrong; the position of the
+	// highest differing significand bit between the old and the new
+	// value, or 0 if their signs or exponents differ; their distance
+	// in ULPs.
+	int status, bits;
+	int64_t diff;
+
+	// Ranges: counts and maximum integer scores of the improvements
+	// and of the worsenings.
+	int32_t count[2];
+	int64_t max[2];
+
+	// Misrounded: count, of the total number of points.
+	int64_t misrounded, total;
+
+	// Top: the list is in status, the integer score in diff, and the
+	// values are those of a point, with the relative score after them.
+
+	// Histograms: whether of the old or the new values is in status,
+	// the lowest value of the binade (+-2^e, or +-0) in v[0], and its
+	// number of points in total; the points that were not checked
+	// against the accurate value are only in total.
+	int64_t counts[ResHistBuckets];
+
+	// Pyramid: as a range, with the level in status.
+
+	// Samples: the octant in status, the lowest value of the binade in
+	// v[0], and the sampled points in total, with the numbers of them
+	// whose old and new values are not correctly rounded in
+	// counts[ResHistOld] and counts[ResHistNew]; the estimated rates
+	// of those, with the bounds of their confidence intervals, in the
+	// slots after v[0].
+
+	unsigned char v[ResMaxValues][ResSlotBytes];
+} ResRecord;
+
+// Point and top record value slots.
+enum {
+	ResX,
+	ResOld,
+	ResNew,
+	ResAccurate,
+	ResScore,
+};
+
+// Range record value slots.
+enum {
+	ResLimit0,
+	ResLimit1,
+	ResImprovMaxScor,
+	ResImprovMean2,
+	ResWorseMaxScor,
+	ResWorseMean2,
+	ResMean1,
+};
+
+// Sample record value slots.
+enum {
+	ResBinade,
+	ResOldRate,
+	ResOldLow,
+	ResOldHigh,
+	ResNewRate,
+	ResNewLow,
+	ResNewHigh,
+};
+
+// State of the rendering of a stream into the text form.
+typedef struct {
+	const ResHeader *h;
+
+	// Whether the range section has started, and the last function
+	// whose name was printed in it; whether the top, the histogram,
+	// the pyramid or the sample section has, and the last list,
+	// histogram, level or function whose heading was printed.
+	int ranges, fn, top, list, hist, level, sample;
+} ResText;
+
+// State of the parsing of a report in the text form into records. The
+// header gets the function names as they appear, and the kind of the
+// values from the digits and the widths of their fields.
+typedef struct {
+	FILE *f;
+	ResHeader h;
+
+	// Whether the kind of the values is known yet, and whether the
+	// range, the top, the histogram, the pyramid and the sample section
+	// have started.
+	int kindKnown, ranges, top, hist, pyramid, sample;
+
+	// The function of the ranges or of the top list being read, the
+	// list or level, and the position of each function in the range section,
+	// or -1.
+	int fn, list, pos[ResMaxFuncs], npos;
+
+	// The number of the last line read.
+	long line;
+} ResTextReader;
+
+// An order preserving key of a value: keys compare like the values do,
+// with -0 before +0.
+typedef struct {
+	uint64_t hi, lo;
+} ResKey;
+
+void resInitHeader(ResHeader *, int, int, int, const char *const *);
+int resValueBytes(int);
+void resSetValue(const ResHeader *, unsigned char *, const void *);
+size_t resRecordBytes(const ResHeader *, int);
+
+int resWriteHeader(FILE *, const ResHeader *);
+int resWrite(FILE *, const ResHeader *, const ResRecord *);
+int resCheckHeader(ResHeader *);
+int resReadHeader(FILE *, ResHeader *);
+int resRead(FILE *, const ResHeader *, ResRecord *);
+size_t resEncode(const ResHeader *, const ResRecord *, unsigned char *);
+size_t resDecode(const ResHeader *, const unsigned char *, size_t, ResRecord *);
+
+ResKey resKey(const ResHeader *, const unsigned char *);
+ResKey resRecordKey(const ResHeader *, const unsigned char *);
+int resKeyCmp(ResKey, ResKey);
+int resParseValue(const ResHeader *, const char *, unsigned char *);
+
+int resFormatDouble(double, char *);
+int resShortestDouble(double, char *);
+void resFormatValue(const ResHeader *, const unsigned char *, char *);
+int resFormat(const ResHeader *, const ResRecord *, char *);
+void resTextInit(ResText *, const ResHeader *);
+void resText(ResText *, FILE *, const ResRecord *);
+void resTextEnd(ResText *, FILE *);
+void resTextReaderInit(ResTextReader *, FILE *);
+int resReadText(ResTextReader *, ResRecord *);
+
+// The store: the records of a report, grouped into a bucket for each
+// function and class (the ranges, each classification of the points,
+// the misrounded count, the top lists, the histograms, each level of
+// the pyramid, and the samples), so that the checker writes it
+// directly, and that the records selected by function, class and an
+// interval of x are found with a binary search, in a mapping of the
+// file.
+//
+// A store is a ResStoreHeader followed by the buckets. Each bucket is
+// its records, sorted by x (the lower limit for the ranges and the
+// nodes of the pyramid; the other records keep their order), followed
+// by its sparse index: the key of every ResIndexStride-th record. The
+// records may be added in any order, but the checker's sweeps give
+// them sorted, except for the negative numbers of the narrow formats.
+
+#define ResStoreMagic "CNFSTO5\n"
+
+enum {
+	// Classes of records; the points' are their classifications.
+	ResStoreRanges = 0,
+	ResStoreMisrounded = ResWrong + 1,
+	ResStoreTop,
+	ResStoreHist,
+
+	// A class for each level of the pyramid, from 1.
+	ResStorePyramid,
+	ResStoreSample = ResStorePyramid + ResPyramidLevels,
+	ResStoreClasses,
+
+	ResIndexStride = 1024,
+
+	// resStoreAdd and resStoreFinish error.
+	ResStoreWriteError = -1,
+};
+
+typedef struct {
+	// Offsets of the records and of the index, from the start of the
+	// store, and the number of records.
+	uint64_t offset, index, count;
+} ResBucket;
+
+typedef struct {
+	char magic[8];
+	uint32_t indexStride, pad;
+	ResHeader h;
+	ResBucket buckets[ResMaxFuncs][ResStoreClasses];
+} ResStoreHeader;
+
+typedef struct {
+	ResHeader h;
+
+	// Temporary files with the records and the index of each bucket,
+	// opened on their first record.
+	FILE *data[ResMaxFuncs][ResStoreClasses], *index[ResMaxFuncs][ResStoreClasses];
+	uint64_t count[ResMaxFuncs][ResStoreClasses];
+	ResKey last[ResMaxFuncs][ResStoreClasses];
+
+	// Whether the records of the bucket came out of order, so that
+	// it needs to be sorted.
+	int unsorted[ResMaxFuncs][ResStoreClasses];
+} ResStoreWriter;
+
+// A store mapped into memory.
+typedef struct {
+	const unsigned char *p;
+	size_t size;
+	ResStoreHeader sh;
+} ResStore;
+
+int resStoreClass(const ResRecord *);
+void resStoreWriterInit(ResStoreWriter *, const ResHeader *);
+int resStoreAdd(ResStoreWriter *, const ResRecord *);
+int resStoreFinish(ResStoreWriter *, FILE *);
+
+int resStoreOpen(ResStore *, const char *);
+void resStoreClose(ResStore *);
+uint64_t resStoreCount(const ResStore *, int, int);
+uint64_t resStoreLowerBound(const ResStore *, int, int, ResKey);
+ResKey resStoreKey(const ResStore *, int, int, uint64_t);
+void resStoreGet(const ResStore *, int, int, uint64_t, ResRecord *);
+
+// The compressed form: ResZMagic, then a zlib stream of a stream in the
+// binary form in which the x of each point is replaced by the
+// difference of its bit pattern from the previous point's, its new and
+// accurate values by their xor with the old value, and the limits of
+// each range by their differences from the previous range's upper
+// limit and from the lower limit. The values are taken as 64 bit words
+// for the differences. The sweeps' inputs are consecutive and their
+// results near each other, so this gives mostly zeros.
+
+#define ResZMagic "CNFRZS1\n"
+
+typedef struct ResZWriter ResZWriter;
+typedef struct ResZReader ResZReader;
+
+ResZWriter *resZWriterOpen(FILE *, const ResHeader *);
+int resZWrite(ResZWriter *, const ResRecord *);
+int resZWriterClose(ResZWriter *);
+
+ResZReader *resZReaderOpen(FILE *);
+const ResHeader *resZHeader(const ResZReader *);
+int resZRead(ResZReader *, ResRecord *);
+void resZReaderClose(ResZReader *);
+
+// A log of records: the caller appends the records, encoded, to blocks
+// of its own, and a writer thread decodes each full block and passes
+// its records to the sink, so that the formatting and the output are
+// done off the caller's thread. The caller never waits for the writer
+// thread; drained blocks are reused, and new ones are allocated while
+// none is free. A log takes records from one thread: each thread that
+// reports opens its own.
+
+// A sink takes a record on the writer thread, and returns nonzero on
+// failure.
+typedef int (*ResSink)(void *, const ResRecord *);
+
+typedef struct ResLog ResLog;
+
+ResLog *resLogOpen(const ResHeader *, ResSink, void *);
+int resLog(ResLog *, const ResRecord *);
+int resLogClose(ResLog *);
+
+// The top lists: for each function, the points with the largest
+// improvements and worsenings, by the integer and by the relative
+// score, kept in bounded heaps while the points stream by. Ties go to
+// the lower x, so that merging the heaps of the shards of a sweep, in
+// any order, gives the heaps of the whole sweep.
+
+enum {
+	// The lists.
+	ResTopBestI,
+	ResTopWorstI,
+	ResTopBestF,
+	ResTopWorstF,
+	ResTopLists,
+
+	// Points in a list.
+	ResTopMax = 100,
+};
+
+typedef struct {
+	// The rank of the record in its list, higher first, and its x.
+	ResKey score, x;
+	ResRecord r;
+} ResTopEntry;
+
+// A heap of the top of a list: e[0] is the lowest entry.
+typedef struct {
+	int n;
+	ResTopEntry e[ResTopMax];
+} ResTopHeap;
+
+void resTopAdd(const ResHeader *, ResTopHeap *, const ResRecord *);
+void resTopMerge(ResTopHeap *, const ResTopHeap *);
+void resTopSort(ResTopHeap *);
+
+// The histograms: for each function and binade of x, the numbers of
+// points by the ULP error of the old and of the new value, in buckets
+// of a log scale. They take the same memory for any number of points,
+// and merge by adding the counts.
+
+enum {
+	ResHistOld,
+	ResHistNew,
+};
+
+int resHistBucket(uint64_t);
+void resHistMerge(ResRecord *, const ResRecord *);
+
+// Merging of ranges and nodes of the pyramid, of one function: a summary
+// of any interval comes from the nodes that cover it, at any level.
+
+void resRangeMerge(const ResHeader *, ResRecord *, const ResRecord *);
+
+// Arenas: memory for many allocations that live until the end of a
+// run, taken from large mapped chunks by bumping a pointer, and
+// released all at once. The last allocation can grow in place, for
+// arrays that double as they fill up.
+
+typedef struct ResArena ResArena;
+
+typedef struct {
+	// Allocations, and their bytes, including growth; growths done in
+	// place, and the bytes copied by the others.
+	uint64_t allocs, bytes, grownInPlace, copiedBytes;
+
+	// Chunks mapped, and their bytes; chunks advised to be backed by
+	// huge pages.
+	uint64_t chunks, mappedBytes, hugeChunks;
+} ResArenaStats;
+
+ResArena *resArenaOpen(int);
+void *resArenaAlloc(ResArena *, size_t);
+void *resArenaGrow(ResArena *, void *, size_t, size_t);
+void resArenaStats(const ResArena *, ResArenaStats *);
+void resArenaClose(ResArena *);
@@ -0,0 +1,70 @@
+// Copyright © 2020 Neven Sajko. All rights reserved.
+
+// Decompresses a report in the compressed form (see results.h), as
+// written by the checker when compiled with CHECK_COMPRESS, into the
+// binary form, or with -t into the text form.
+//
+// Usage:
+//
+//    resunz [-t] [file]
+//
+// Without a file, the standard input is read.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "results.h"
+
+#define nil 0
+
+int
+main(int argc, char *argv[]) {
+	int text = 1 < argc && strcmp(argv[1], "-t") == 0;
+	if (2 + text < argc) {
+		fprintf(stderr, "usage: resunz [-t] [file]\n");
+		return 2;
+	}
+	FILE *in = stdin;
+	if (argc == 2 + text && (in = fopen(argv[1 + text], "rb")) == nil) {
+		fprintf(stderr, "resunz: cannot open %s\n", argv[1 + text]);
+		return 1;
+	}
+	setvbuf(stdout, nil, _IOFBF, ResBufferBytes);
+
+	ResZReader *z = resZReaderOpen(in);
+	if (z == nil) {
+		fprintf(stderr, "resunz: not a report in the compressed form, or from a machine with another byte order\n");
+		return 1;
+	}
+	const ResHeader *h = resZHeader(z);
+	ResText t;
+	resTextInit(&t, h);
+	if (!text && resWriteHeader(stdout, h)) {
+		fprintf(stderr, "resunz: write error\n");
+		return 1;
+	}
+	ResRecord r;
+	int e;
+	while ((e = resZRead(z, &r)) == 1) {
+		if (text) {
+			resText(&t, stdout, &r);
+		} else if (resWrite(stdout, h, &r)) {
+			break;
+		}
+	}
+	if (e < 0) {
+		fprintf(stderr, "resunz: invalid or truncated stream\n");
+		return 1;
+	}
+	if (text) {
+		resTextEnd(&t, stdout);
+	}
+	resZReaderClose(z);
+	if (fflush(stdout) || ferror(stdout)) {
+		fprintf(stderr, "resunz: write error\n");
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,384 @@
+// Writing and reading of stores, see results.h.
+
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "results.h"
+
+#define nil 0
+
+enum {
+	// Memory for sorting a run of records, in resStoreFinish.
+	SortBytes = 64 << 20,
+};
+
+int
+resStoreClass(const ResRecord *r) {
+	switch (r->tag) {
+	case ResPoint:
+		return r->status;
+	case ResRange:
+		return ResStoreRanges;
+	case ResTop:
+		return ResStoreTop;
+	case ResHist:
+		return ResStoreHist;
+	case ResPyramid:
+		return ResStorePyramid + r->status - 1;
+	case ResSample:
+		return ResStoreSample;
+	}
+	return ResStoreMisrounded;
+}
+
+// The tag of the records of the class.
+static
+int
+classTag(int class) {
+	switch (class) {
+	case ResStoreRanges:
+		return ResRange;
+	case ResStoreMisrounded:
+		return ResMisrounded;
+	case ResStoreTop:
+		return ResTop;
+	case ResStoreHist:
+		return ResHist;
+	case ResStoreSample:
+		return ResSample;
+	}
+	if (ResStorePyramid <= class) {
+		return ResPyramid;
+	}
+	return ResPoint;
+}
+
+void
+resStoreWriterInit(ResStoreWriter *w, const ResHeader *h) {
+	memset(w, 0, sizeof(*w));
+	w->h = *h;
+}
+
+// Adds r to its bucket. Returns 0 on success.
+int
+resStoreAdd(ResStoreWriter *w, const ResRecord *r) {
+	int fn = r->fn, c = resStoreClass(r);
+	unsigned char buf[ResMaxRecordBytes];
+	size_t n = resEncode(&w->h, r, buf);
+	ResKey k = resRecordKey(&w->h, buf);
+	if (w->data[fn][c] == nil) {
+		w->data[fn][c] = tmpfile();
+		w->index[fn][c] = tmpfile();
+		if (w->data[fn][c] == nil || w->index[fn][c] == nil) {
+			return ResStoreWriteError;
+		}
+	} else if (resKeyCmp(k, w->last[fn][c]) < 0) {
+		// The bucket gets sorted in resStoreFinish.
+		w->unsorted[fn][c] = 1;
+	}
+	if (w->count[fn][c] % ResIndexStride == 0 && fwrite(&k, sizeof(k), 1, w->index[fn][c]) != 1) {
+		return ResStoreWriteError;
+	}
+	if (fwrite(buf, 1, n, w->data[fn][c]) != n) {
+		return ResStoreWriteError;
+	}
+	w->last[fn][c] = k;
+	w->count[fn][c]++;
+	return 0;
+}
+
+// Appends the contents of the temporary file f to out, and closes f.
+static
+int
+copyTemporary(FILE *f, FILE *out, char *buf) {
+	int e = fflush(f) != 0 || fseek(f, 0, SEEK_SET) != 0;
+	size_t n;
+	while (!e && (n = fread(buf, 1, ResBufferBytes, f)) != 0) {
+		e = fwrite(buf, 1, n, out) != n;
+	}
+	e = e || ferror(f);
+	return fclose(f) != 0 || e;
+}
+
+typedef struct {
+	ResKey k;
+	uint64_t i;
+} keyed;
+
+static
+int
+keyedCmp(const void *a, const void *b) {
+	const keyed *x = a, *y = b;
+	int c = resKeyCmp(x->k, y->k);
+	if (c != 0) {
+		return c;
+	}
+	return x->i < y->i ? -1 : x->i > y->i;
+}
+
+// A sorted run of a bucket, being merged.
+typedef struct {
+	FILE *f;
+	ResKey k;
+	unsigned char rec[ResMaxRecordBytes];
+} run;
+
+// Whether run a comes before run b; earlier runs first for equal keys,
+// so that the sort is stable.
+static
+int
+runBefore(const run *runs, int a, int b) {
+	int c = resKeyCmp(runs[a].k, runs[b].k);
+	return c < 0 || c == 0 && a < b;
+}
+
+static
+void
+siftDown(const run *runs, int *heap, int n, int i) {
+	for (;;) {
+		int m = i, l = 2*i + 1, r = l + 1;
+		if (l < n && runBefore(runs, heap[l], heap[m])) {
+			m = l;
+		}
+		if (r < n && runBefore(runs, heap[r], heap[m])) {
+			m = r;
+		}
+		if (m == i) {
+			return;
+		}
+		int t = heap[i];
+		heap[i] = heap[m];
+		heap[m] = t;
+		i = m;
+	}
+}
+
+// Reads the next record of the run, returns 0 at its end.
+static
+int
+runNext(const ResHeader *h, run *r, size_t size) {
+	if (fread(r->rec, 1, size, r->f) != size) {
+		return 0;
+	}
+	r->k = resRecordKey(h, r->rec);
+	return 1;
+}
+
+// Writes the records of the temporary file data, of which there are
+// count, to out in the order of their keys, and their index to the
+// temporary file index, and closes data. The records are sorted in runs
+// of SortBytes, which are then merged, so that the bucket does not have
+// to fit in memory.
+static
+int
+sortBucket(const ResHeader *h, FILE *data, uint64_t count, size_t size, FILE *out, FILE *index) {
+	uint64_t per = SortBytes / size, nRuns = (count + per - 1) / per, i, j;
+	unsigned char *buf = malloc(per * size), *sorted = malloc(per * size);
+	keyed *ks = malloc(per * sizeof(keyed));
+	run *runs = calloc(nRuns, sizeof(run));
+	int *heap = malloc(nRuns * sizeof(int));
+	int e = buf == nil || sorted == nil || ks == nil || runs == nil || heap == nil ||
+		fflush(data) != 0 || fseek(data, 0, SEEK_SET) != 0;
+	for (i = 0; !e && i < nRuns; i++) {
+		uint64_t n = count - i*per < per ? count - i*per : per;
+		e = fread(buf, size, n, data) != n || (runs[i].f = tmpfile()) == nil;
+		for (j = 0; !e && j < n; j++) {
+			ks[j].k = resRecordKey(h, &buf[j*size]);
+			ks[j].i = j;
+		}
+		if (!e) {
+			qsort(ks, n, sizeof(keyed), keyedCmp);
+			for (j = 0; j < n; j++) {
+				memcpy(&sorted[j*size], &buf[ks[j].i*size], size);
+			}
+			e = fwrite(sorted, size, n, runs[i].f) != n || fflush(runs[i].f) != 0 ||
+				fseek(runs[i].f, 0, SEEK_SET) != 0;
+		}
+	}
+	e = fclose(data) != 0 || e;
+	free(buf);
+	free(sorted);
+	free(ks);
+
+	int n = 0;
+	for (i = 0; !e && i < nRuns; i++) {
+		if (runNext(h, &runs[i], size)) {
+			heap[n++] = (int)i;
+		}
+	}
+	for (i = (uint64_t)n/2; !e && 0 < i; i--) {
+		siftDown(runs, heap, n, (int)i - 1);
+	}
+	for (j = 0; !e && 0 < n; j++) {
+		run *r = &runs[heap[0]];
+		if (j % ResIndexStride == 0) {
+			e = fwrite(&r->k, sizeof(r->k), 1, index) != 1;
+		}
+		e = e || fwrite(r->rec, 1, size, out) != size;
+		if (!runNext(h, r, size)) {
+			heap[0] = heap[--n];
+		}
+		siftDown(runs, heap, n, 0);
+	}
+	for (i = 0; runs != nil && i < nRuns; i++) {
+		if (runs[i].f != nil) {
+			fclose(runs[i].f);
+		}
+	}
+	free(runs);
+	free(heap);
+	return e || j != count;
+}
+
+// Writes the store to out, and releases the temporary files. Returns 0
+// on success.
+int
+resStoreFinish(ResStoreWriter *w, FILE *out) {
+	ResStoreHeader sh;
+	memset(&sh, 0, sizeof(sh));
+	memcpy(sh.magic, ResStoreMagic, sizeof(sh.magic));
+	sh.indexStride = ResIndexStride;
+	sh.h = w->h;
+	uint64_t off = sizeof(sh);
+	int fn, c;
+	for (fn = 0; fn < ResMaxFuncs; fn++) {
+		for (c = 0; c < ResStoreClasses; c++) {
+			ResBucket *b = &sh.buckets[fn][c];
+			b->count = w->count[fn][c];
+			b->offset = off;
+			off += b->count * resRecordBytes(&w->h, classTag(c));
+			b->index = off;
+			off += (b->count + ResIndexStride - 1) / ResIndexStride * sizeof(ResKey);
+		}
+	}
+
+	char *buf = malloc(ResBufferBytes);
+	int e = buf == nil || fwrite(&sh, sizeof(sh), 1, out) != 1;
+	for (fn = 0; fn < ResMaxFuncs; fn++) {
+		for (c = 0; c < ResStoreClasses; c++) {
+			if (w->data[fn][c] == nil) {
+				continue;
+			}
+			if (w->unsorted[fn][c]) {
+				// Replace the index too.
+				fclose(w->index[fn][c]);
+				w->index[fn][c] = tmpfile();
+				e = w->index[fn][c] == nil || e ||
+					sortBucket(&w->h, w->data[fn][c], w->count[fn][c], resRecordBytes(&w->h, classTag(c)), out, w->index[fn][c]);
+			} else {
+				e = copyTemporary(w->data[fn][c], out, buf) || e;
+			}
+			e = w->index[fn][c] == nil || copyTemporary(w->index[fn][c], out, buf) || e;
+			w->data[fn][c] = w->index[fn][c] = nil;
+		}
+	}
+	free(buf);
+	return e || fflush(out) != 0 ? ResStoreWriteError : 0;
+}
+
+// Maps the store at path into memory. Returns 0 on success.
+int
+resStoreOpen(ResStore *s, const char *path) {
+	int fd = open(path, O_RDONLY);
+	if (fd < 0) {
+		return -1;
+	}
+	struct stat st;
+	if (fstat(fd, &st) != 0 || (uint64_t)st.st_size < sizeof(s->sh)) {
+		close(fd);
+		return -1;
+	}
+	s->size = (size_t)st.st_size;
+	void *p = mmap(nil, s->size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (p == MAP_FAILED) {
+		return -1;
+	}
+	s->p = p;
+	memcpy(&s->sh, s->p, sizeof(s->sh));
+
+	const ResHeader *h = &s->sh.h;
+	int ok = memcmp(s->sh.magic, ResStoreMagic, sizeof(s->sh.magic)) == 0 && s->sh.indexStride != 0 &&
+		resCheckHeader(&s->sh.h) == 0;
+	int fn, c;
+	for (fn = 0; ok && fn < ResMaxFuncs; fn++) {
+		for (c = 0; ok && c < ResStoreClasses; c++) {
+			const ResBucket *b = &s->sh.buckets[fn][c];
+			uint64_t m = (b->count + s->sh.indexStride - 1) / s->sh.indexStride;
+			ok = b->offset <= s->size && b->count <= (s->size - b->offset) / resRecordBytes(h, classTag(c)) &&
+				b->index <= s->size && m <= (s->size - b->index) / sizeof(ResKey) &&
+				(b->count == 0 || fn < h->funcCount);
+		}
+	}
+	if (!ok) {
+		resStoreClose(s);
+		return -1;
+	}
+	return 0;
+}
+
+void
+resStoreClose(ResStore *s) {
+	munmap((void *)s->p, s->size);
+	s->p = nil;
+}
+
+uint64_t
+resStoreCount(const ResStore *s, int fn, int class) {
+	return s->sh.buckets[fn][class].count;
+}
+
+static
+const unsigned char *
+record(const ResStore *s, int fn, int class, uint64_t i) {
+	const ResBucket *b = &s->sh.buckets[fn][class];
+	return &s->p[b->offset + i*resRecordBytes(&s->sh.h, classTag(class))];
+}
+
+// The key of the i-th record of the bucket.
+ResKey
+resStoreKey(const ResStore *s, int fn, int class, uint64_t i) {
+	return resRecordKey(&s->sh.h, record(s, fn, class, i));
+}
+
+void
+resStoreGet(const ResStore *s, int fn, int class, uint64_t i, ResRecord *r) {
+	resDecode(&s->sh.h, record(s, fn, class, i), ResMaxRecordBytes, r);
+}
+
+// The position of the first record of the bucket whose key is not less
+// than k. The sparse index gives the block of ResIndexStride records,
+// which is then searched.
+uint64_t
+resStoreLowerBound(const ResStore *s, int fn, int class, ResKey k) {
+	const ResBucket *b = &s->sh.buckets[fn][class];
+	uint64_t stride = s->sh.indexStride, m = (b->count + stride - 1) / stride;
+	uint64_t lo = 0, hi = m;
+	while (lo < hi) {
+		uint64_t mid = lo + (hi - lo)/2;
+		ResKey ik;
+		memcpy(&ik, &s->p[b->index + mid*sizeof(ik)], sizeof(ik));
+		if (resKeyCmp(ik, k) < 0) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+	hi = lo == m ? b->count : lo*stride;
+	lo = lo == 0 ? 0 : (lo - 1)*stride;
+	while (lo < hi) {
+		uint64_t mid = lo + (hi - lo)/2;
+		if (resKeyCmp(resStoreKey(s, fn, class, mid), k) < 0) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+	return lo;
+}
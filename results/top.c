@@ -0,0 +1,106 @@
+// The top lists, see results.h.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "results.h"
+
+#define nil 0
+
+// Whether a ranks above b.
+static
+int
+above(const ResTopEntry *a, const ResTopEntry *b) {
+	int c = resKeyCmp(a->score, b->score);
+	return 0 < c || c == 0 && resKeyCmp(a->x, b->x) < 0;
+}
+
+// The rank of r in its list: its score, reversed for the worst lists.
+static
+ResKey
+rank(const ResHeader *h, const ResRecord *r) {
+	ResKey k = {0, (uint64_t)r->diff ^ (uint64_t)1 << 63};
+	if (r->status == ResTopBestF || r->status == ResTopWorstF) {
+		k = resKey(h, r->v[ResScore]);
+	}
+	if (r->status == ResTopWorstI || r->status == ResTopWorstF) {
+		k.hi = ~k.hi;
+		k.lo = ~k.lo;
+	}
+	return k;
+}
+
+static
+void
+siftUp(ResTopHeap *t, int i) {
+	while (0 < i && above(&t->e[(i - 1)/2], &t->e[i])) {
+		ResTopEntry e = t->e[i];
+		t->e[i] = t->e[(i - 1)/2];
+		t->e[(i - 1)/2] = e;
+		i = (i - 1)/2;
+	}
+}
+
+static
+void
+siftDown(ResTopHeap *t, int i) {
+	for (;;) {
+		int m = i, c;
+		for (c = 2*i + 1; c <= 2*i + 2 && c < t->n; c++) {
+			if (above(&t->e[m], &t->e[c])) {
+				m = c;
+			}
+		}
+		if (m == i) {
+			return;
+		}
+		ResTopEntry e = t->e[i];
+		t->e[i] = t->e[m];
+		t->e[m] = e;
+		i = m;
+	}
+}
+
+static
+void
+add(ResTopHeap *t, const ResTopEntry *e) {
+	if (t->n < ResTopMax) {
+		t->e[t->n] = *e;
+		siftUp(t, t->n++);
+	} else if (above(e, &t->e[0])) {
+		t->e[0] = *e;
+		siftDown(t, 0);
+	}
+}
+
+// Offers the top record r to the heap of its list.
+void
+resTopAdd(const ResHeader *h, ResTopHeap *t, const ResRecord *r) {
+	ResTopEntry e;
+	e.score = rank(h, r);
+	e.x = resKey(h, r->v[ResX]);
+	e.r = *r;
+	add(t, &e);
+}
+
+// Adds the entries of the heap b, of the same list, to a.
+void
+resTopMerge(ResTopHeap *a, const ResTopHeap *b) {
+	int i;
+	for (i = 0; i < b->n; i++) {
+		add(a, &b->e[i]);
+	}
+}
+
+static
+int
+cmpEntries(const void *a, const void *b) {
+	return above(a, b) ? -1 : above(b, a);
+}
+
+// Sorts the entries, highest first; t is no longer a heap after it.
+void
+resTopSort(ResTopHeap *t) {
+	qsort(t->e, (size_t)t->n, sizeof(t->e[0]), cmpEntries);
+}